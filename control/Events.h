@@ -1,7 +1,11 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <vector>
 #include <functional>
+#include <new>
+#include <tuple>
 #include <utility>
 #include <type_traits>
 
@@ -40,4 +44,161 @@ namespace Ath::Control
             });
         }
     };
+
+    /**
+     * @brief Event output with a fixed number of callback slots, for the audio thread.
+     *
+     * Callables are copied into inline storage in each slot and called through
+     * a plain function pointer, so neither connecting nor firing ever allocates.
+     * Callables must be trivially copyable and fit in StorageSize bytes, which
+     * covers lambdas capturing a few references or pointers and member function pointers.
+     *
+     * @tparam T Event type
+     * @tparam Capacity Maximum number of callbacks
+     * @tparam StorageSize Inline storage per callback, in bytes
+     */
+    template <typename T, int Capacity = 4, int StorageSize = 4 * sizeof(void*)>
+    class FixedEventOutput
+    {
+        struct Slot
+        {
+            alignas(std::max_align_t) unsigned char storage[StorageSize];
+            void (*invoke)(const void* storage, const T& value);
+        };
+
+        std::array<Slot, Capacity> slots;
+        int numberOfCallbacks = 0;
+
+    public:
+        static constexpr int capacity = Capacity;
+
+        void fire(const T& value) const
+        {
+            for (int i = 0; i < numberOfCallbacks; i++) slots[i].invoke(slots[i].storage, value);
+        }
+
+        /**
+         * @brief Connect a callable.
+         *
+         * @return false if all slots are taken; the callable is not connected
+         */
+        template <typename F>
+        [[nodiscard]] bool addCallback(F&& f)
+        {
+            using Callable = std::decay_t<F>;
+
+            static_assert(
+                std::is_invocable_v<const Callable&, const T&>,
+                "Callback must be callable with (const T&)"
+            );
+            static_assert(sizeof(Callable) <= StorageSize, "Callback does not fit in the inline storage, raise StorageSize");
+            static_assert(alignof(Callable) <= alignof(std::max_align_t), "Callback is over-aligned");
+            static_assert(std::is_trivially_copyable_v<Callable> && std::is_trivially_destructible_v<Callable>,
+                "Callback must be trivially copyable; capture references or pointers instead of owning objects");
+
+            if (numberOfCallbacks == Capacity) return false;
+
+            Slot& slot = slots[numberOfCallbacks++];
+            ::new (static_cast<void*>(slot.storage)) Callable(std::forward<F>(f));
+            slot.invoke = [](const void* storage, const T& value)
+            {
+                (*std::launder(static_cast<const Callable*>(storage)))(value);
+            };
+
+            return true;
+        }
+
+        /**
+         * @brief Connect a member function known at compile time. The call is inlined into the slot's thunk.
+         */
+        template <auto MemberFunction, typename InstanceType>
+        [[nodiscard]] bool addMemberCallback(InstanceType& instance)
+        {
+            InstanceType* pointer = &instance;
+            return addCallback([pointer](const T& v) { std::invoke(MemberFunction, *pointer, v); });
+        }
+
+        /**
+         * @brief Connect a member function given at runtime. Same signature as EventOutput::addMemberCallback.
+         */
+        template <typename InstanceType, typename MemberFunction>
+        [[nodiscard]] bool addMemberCallback(InstanceType& instance, MemberFunction member_function)
+        {
+            InstanceType* pointer = &instance;
+            return addCallback([pointer, member_function](const T& v) { std::invoke(member_function, *pointer, v); });
+        }
+
+        void clear() { numberOfCallbacks = 0; }
+
+        int getNumberOfCallbacks() const { return numberOfCallbacks; }
+    };
+
+    /**
+     * @brief Connect a callable to an EventOutput or a FixedEventOutput.
+     *
+     * For code that takes either output type.
+     *
+     * @return false if a FixedEventOutput has no free slot; always true for an EventOutput
+     */
+    template <typename Output, typename F>
+    [[nodiscard]] bool tryAddCallback(Output& output, F&& f)
+    {
+        if constexpr (std::is_void_v<decltype(output.addCallback(std::forward<F>(f)))>)
+        {
+            output.addCallback(std::forward<F>(f));
+            return true;
+        }
+        else
+        {
+            return output.addCallback(std::forward<F>(f));
+        }
+    }
+
+    /**
+     * @brief Callable that forwards to a compile-time member function of an instance.
+     */
+    template <auto MemberFunction, typename InstanceType>
+    struct MemberCallback
+    {
+        InstanceType* instance;
+
+        template <typename T>
+        void operator()(const T& value) const { std::invoke(MemberFunction, *instance, value); }
+    };
+
+    template <auto MemberFunction, typename InstanceType>
+    MemberCallback<MemberFunction, InstanceType> bindMember(InstanceType& instance)
+    {
+        return { &instance };
+    }
+
+    /**
+     * @brief Event output whose receivers are part of its type.
+     *
+     * Connections are fixed at construction and fire() calls each receiver
+     * directly, so the compiler can inline the whole fan-out. Use
+     * connectStatic<T>(...) to build one.
+     */
+    template <typename T, typename... Callables>
+    class StaticEventOutput
+    {
+        std::tuple<Callables...> callables;
+
+    public:
+        constexpr explicit StaticEventOutput(Callables... c) : callables(std::move(c)...)
+        {
+            static_assert((std::is_invocable_v<const Callables&, const T&> && ...), "Callbacks must be callable with (const T&)");
+        }
+
+        void fire(const T& value) const
+        {
+            std::apply([&value](const auto&... callable) { (callable(value), ...); }, callables);
+        }
+    };
+
+    template <typename T, typename... Callables>
+    constexpr StaticEventOutput<T, Callables...> connectStatic(Callables... callables)
+    {
+        return StaticEventOutput<T, Callables...>(std::move(callables)...);
+    }
 }
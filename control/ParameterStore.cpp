@@ -0,0 +1,67 @@
+#include <algorithm>
+
+#include "ParameterStore.h"
+
+namespace Ath::Control
+{
+
+    ParameterStore::ParameterStore (const std::vector<Parameter>& parameters, int queueCapacity)
+        : values (std::make_unique<std::atomic<float>[]> (parameters.size())),
+          numberOfParameters (static_cast<int> (parameters.size())),
+          changes (static_cast<size_t> (std::max (queueCapacity, 1))),
+          dirty (static_cast<int> (parameters.size()))
+    {
+        ids.reserve (parameters.size());
+        minimums.reserve (parameters.size());
+        maximums.reserve (parameters.size());
+
+        for (int i = 0; i < numberOfParameters; i++)
+        {
+            const Parameter& parameter = parameters[i];
+
+            ids.push_back (parameter.id);
+            minimums.push_back (std::min (parameter.min, parameter.max));
+            maximums.push_back (std::max (parameter.min, parameter.max));
+            values[i].store (std::clamp (parameter.def, minimums[i], maximums[i]), std::memory_order_relaxed);
+        }
+    }
+
+    int ParameterStore::getIndex (const std::string& id) const
+    {
+        const auto it = std::find (ids.begin(), ids.end(), id);
+        return it == ids.end() ? -1 : static_cast<int> (it - ids.begin());
+    }
+
+    void ParameterStore::setValue (int index, float value)
+    {
+        if (index < 0 || index >= numberOfParameters) return;
+
+        values[index].store (std::clamp (value, minimums[index], maximums[index]), std::memory_order_relaxed);
+
+        // The queue's release store publishes the value above to the audio thread
+        if (!changes.push (index))
+            markAllDirty();
+    }
+
+    const ParameterSet& ParameterStore::collectChanges()
+    {
+        dirty.clear();
+
+        int index;
+        while (changes.pop (index))
+            dirty.insert (index);
+
+        if (allDirty.exchange (false, std::memory_order_acquire))
+        {
+            for (int i = 0; i < numberOfParameters; i++)
+                dirty.insert (i);
+        }
+
+        return dirty;
+    }
+
+    void ParameterStore::markAllDirty()
+    {
+        allDirty.store (true, std::memory_order_release);
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Parameter.h"
+#include "SpscQueue.h"
+
+namespace Ath::Control
+{
+    /**
+     * @brief Set of parameter indices, one bit each, for the audio thread.
+     */
+    class ParameterSet
+    {
+        std::vector<uint64_t> words;
+
+    public:
+        explicit ParameterSet(int numberOfParameters = 0) : words((numberOfParameters + 63) / 64, 0) {}
+
+        void insert(int index) { words[index >> 6] |= uint64_t(1) << (index & 63); }
+
+        bool contains(int index) const { return (words[index >> 6] >> (index & 63)) & 1; }
+
+        void clear() { for (auto& word : words) word = 0; }
+
+        bool empty() const
+        {
+            for (auto word : words) if (word != 0) return false;
+            return true;
+        }
+
+        /**
+         * @brief Call f(index) for every index in the set, in increasing order.
+         */
+        template <typename F>
+        void forEach(F&& f) const
+        {
+            for (int w = 0; w < static_cast<int> (words.size()); w++)
+            {
+                for (uint64_t word = words[w]; word != 0; word &= word - 1)
+                    f((w << 6) + std::countr_zero(word));
+            }
+        }
+    };
+
+    /**
+     * @brief Parameter values shared between a UI/host thread and the audio thread.
+     *
+     * Values live in a contiguous array of atomics indexed by parameter index
+     * (the position of the parameter in the list given to the constructor).
+     * The UI/host thread writes them with setValue, which also pushes the index
+     * to a lock-free single-producer/single-consumer queue. Once per block the
+     * audio thread calls collectChanges to drain the queue into a dirty set and
+     * only updates the smoothers and coefficients of those parameters.
+     *
+     * Nothing on the audio thread side locks, allocates or touches std::string.
+     * If the queue overflows, the next collectChanges reports every parameter,
+     * as does the first one.
+     */
+    class ParameterStore
+    {
+        std::vector<std::string> ids;
+        std::vector<float> minimums;
+        std::vector<float> maximums;
+
+        std::unique_ptr<std::atomic<float>[]> values;
+        int numberOfParameters = 0;
+
+        SpscQueue<int> changes;
+        // Set on queue overflow or by markAllDirty: the next collectChanges reports everything
+        std::atomic<bool> allDirty { true };
+
+        ParameterSet dirty;
+
+    public:
+        /**
+         * @param parameters Descriptors; values start at their defaults and are clamped to [min, max]
+         * @param queueCapacity Changes that can be pending between two blocks before everything is marked dirty
+         */
+        explicit ParameterStore(const std::vector<Parameter>& parameters, int queueCapacity = 1024);
+
+        int getNumberOfParameters() const { return numberOfParameters; }
+
+        /**
+         * @brief Index of a parameter by id, or -1. Not for the audio thread.
+         */
+        int getIndex(const std::string& id) const;
+
+        /**
+         * @brief Set a value from the UI/host thread. Only one thread may call this.
+         */
+        void setValue(int index, float value);
+
+        /**
+         * @brief Current value, from any thread.
+         */
+        float getValue(int index) const { return values[index].load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Audio thread: gather the parameters changed since the last call.
+         *
+         * @return Set of changed indices, valid until the next call
+         */
+        const ParameterSet& collectChanges();
+
+        /**
+         * @brief Report every parameter on the next collectChanges, e.g. after a sample rate change. Any thread.
+         */
+        void markAllDirty();
+    };
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace Ath::Control
+{
+    /**
+     * @brief Bounded lock-free queue for one producer thread and one consumer thread.
+     *
+     * Storage is allocated once in the constructor; push and pop never block,
+     * lock or allocate. The capacity is rounded up to a power of two.
+     *
+     * @tparam T Trivially copyable element type
+     */
+    template <typename T>
+    class SpscQueue
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "SpscQueue elements must be trivially copyable");
+
+        // Keeps the producer and consumer indices on separate cache lines
+        static constexpr size_t cacheLineSize = 64;
+
+        std::unique_ptr<T[]> buffer;
+        size_t mask = 0;
+
+        alignas(cacheLineSize) std::atomic<size_t> writeIndex { 0 };
+        alignas(cacheLineSize) std::atomic<size_t> readIndex { 0 };
+
+    public:
+        explicit SpscQueue(size_t minimumCapacity)
+        {
+            size_t capacity = 1;
+            while (capacity < minimumCapacity) capacity <<= 1;
+
+            buffer = std::make_unique<T[]>(capacity);
+            mask = capacity - 1;
+        }
+
+        size_t capacity() const { return mask + 1; }
+
+        /**
+         * @brief Producer side.
+         *
+         * @return false if the queue is full; the value is dropped
+         */
+        bool push(const T& value)
+        {
+            const size_t write = writeIndex.load(std::memory_order_relaxed);
+            if (write - readIndex.load(std::memory_order_acquire) > mask) return false;
+
+            buffer[write & mask] = value;
+            writeIndex.store(write + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Consumer side.
+         *
+         * @return false if the queue is empty
+         */
+        bool pop(T& value)
+        {
+            const size_t read = readIndex.load(std::memory_order_relaxed);
+            if (read == writeIndex.load(std::memory_order_acquire)) return false;
+
+            value = buffer[read & mask];
+            readIndex.store(read + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool empty() const
+        {
+            return readIndex.load(std::memory_order_acquire) == writeIndex.load(std::memory_order_acquire);
+        }
+    };
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+namespace Ath::Control
+{
+    /**
+     * @brief Latest-value exchange between one writer thread and one reader thread.
+     *
+     * The writer fills its buffer and publishes it; the reader always gets the
+     * most recently published one. Both sides are wait-free: each owns one of
+     * three buffers and swaps it with the shared middle one in a single atomic
+     * exchange, so neither ever waits for, or tears, the other's data.
+     * Values that are published while the reader is not looking are skipped.
+     */
+    template <typename T>
+    class TripleBuffer
+    {
+        static constexpr int indexMask = 3;
+        static constexpr int fresh = 4;
+
+        std::array<T, 3> buffers {};
+
+        int writeIndex = 0;
+        int readIndex = 1;
+
+        // Index of the middle buffer, with the fresh bit set if it was published since the last read
+        alignas(64) std::atomic<int> middle { 2 };
+
+    public:
+        /**
+         * @brief Writer side: the buffer to fill before publish(). Its previous contents are stale.
+         */
+        T& getWriteBuffer() { return buffers[writeIndex]; }
+
+        /**
+         * @brief Writer side: hand the write buffer over to the reader.
+         */
+        void publish()
+        {
+            writeIndex = middle.exchange(writeIndex | fresh, std::memory_order_acq_rel) & indexMask;
+        }
+
+        /**
+         * @brief Reader side: whether read() would return a newer value than last time.
+         */
+        bool hasNewData() const { return (middle.load(std::memory_order_acquire) & fresh) != 0; }
+
+        /**
+         * @brief Reader side.
+         *
+         * @return The latest published value, valid until the next call of read()
+         */
+        const T& read()
+        {
+            if (hasNewData())
+                readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+
+            return buffers[readIndex];
+        }
+    };
+}
@@ -1,66 +1,247 @@
+#include <bit>
+
 #include "VoiceManager.h"
 
 namespace Ath::Control
 {
 
-    EventOutput<Midi::MessageNoteOn>& VoiceManager::noteOn_out (int i) { return voices[i].noteOn_out; };
-    EventOutput<Midi::MessageNoteOff>& VoiceManager::noteOff_out (int i) { return voices[i].noteOff_out; };
+    VoiceManager::VoiceManager (int numberOfVoices)
+        : voices (numberOfVoices > 0 ? numberOfVoices : 1),
+          soundingVoices ((voices.size() + 63) / 64, 0),
+          voicesToRender (voices.size()),
+          groupsToRender (voices.size())
+    {
+        noteToVoice.fill (none);
 
-    bool VoiceManager::isAtLeastOneVoiceActive()
+        for (int i = 0; i < getNumberOfVoices(); i++)
+            pushBack (freeVoices, i);
+    }
+
+    VoiceManager::NoteOnOutput& VoiceManager::noteOn_out (int i) { return voices[i].noteOn_out; };
+    VoiceManager::NoteOffOutput& VoiceManager::noteOff_out (int i) { return voices[i].noteOff_out; };
+
+    int VoiceManager::getNumberOfVoices() const { return static_cast<int> (voices.size()); }
+    int VoiceManager::getNumberOfActiveVoices() const { return numberOfActiveVoices; }
+
+    void VoiceManager::setStealingPolicy (StealingPolicy policy) { stealingPolicy = policy; }
+    VoiceManager::StealingPolicy VoiceManager::getStealingPolicy() const { return stealingPolicy; }
+
+    void VoiceManager::setRetriggerSameNote (bool shouldRetrigger) { retriggerSameNote = shouldRetrigger; }
+    bool VoiceManager::getRetriggerSameNote() const { return retriggerSameNote; }
+
+    void VoiceManager::setVoiceLevel (int i, float level)
     {
-        for (VoiceController& voice : voices)
+        VoiceController& voice = voices[i];
+        voice.level = level;
+
+        if (voice.state == VoiceState::Releasing && level <= silenceThreshold)
         {
-            if (voice.active)
-                return true;
+            voice.state = VoiceState::Silent;
+            setSounding (i, false);
         }
-        return false;
     }
 
-    bool VoiceManager::isNoteAlreadyPressed (int note)
+    void VoiceManager::setSilenceThreshold (float threshold) { silenceThreshold = threshold; }
+    float VoiceManager::getSilenceThreshold() const { return silenceThreshold; }
+
+    VoiceManager::VoiceState VoiceManager::getVoiceState (int i) const { return voices[i].state; }
+
+    void VoiceManager::setSounding (int voice, bool sounding)
     {
-        for (VoiceController& voice : voices)
+        const uint64_t bit = uint64_t (1) << (voice % 64);
+        uint64_t& word = soundingVoices[voice / 64];
+
+        if (((word & bit) != 0) == sounding) return;
+
+        word ^= bit;
+        voicesToRenderChanged = true;
+    }
+
+    std::span<const int> VoiceManager::getVoicesToRender()
+    {
+        if (voicesToRenderChanged)
         {
-            if (voice.active && voice.note == note)
-                return true;
+            numberOfVoicesToRender = 0;
+
+            for (int w = 0; w < static_cast<int> (soundingVoices.size()); w++)
+            {
+                for (uint64_t bits = soundingVoices[w]; bits != 0; bits &= bits - 1)
+                    voicesToRender[numberOfVoicesToRender++] = w * 64 + std::countr_zero (bits);
+            }
+
+            voicesToRenderChanged = false;
         }
-        return false;
+
+        return { voicesToRender.data(), static_cast<size_t> (numberOfVoicesToRender) };
     }
 
-    void VoiceManager::handleNoteOn (const Midi::MessageNoteOn message)
+    int VoiceManager::getNumberOfVoicesToRender() { return static_cast<int> (getVoicesToRender().size()); }
+
+    std::span<const int> VoiceManager::getGroupsToRender (int voicesPerGroup)
     {
-        if (isNoteAlreadyPressed(message.note)) return;
+        voicesPerGroup = voicesPerGroup > 0 ? voicesPerGroup : 1;
 
-        for (auto& voice : voices)
+        int numberOfGroups = 0;
+        for (const int voice : getVoicesToRender())
         {
-            if (!voice.active)
-            {
-                voice.active = true;
-                voice.note = message.note;
-                voice.noteOn_out.fire (message);
-
-                return;
-            }
+            const int group = voice / voicesPerGroup;
+            if (numberOfGroups == 0 || groupsToRender[numberOfGroups - 1] != group)
+                groupsToRender[numberOfGroups++] = group;
         }
+
+        return { groupsToRender.data(), static_cast<size_t> (numberOfGroups) };
     }
 
-    void VoiceManager::handleNoteOff (const Midi::MessageNoteOff message)
+    int VoiceManager::getVoiceForNote (int note) const
+    {
+        if (note < 0 || note > 127) return none;
+        return noteToVoice[note];
+    }
+
+    bool VoiceManager::isAtLeastOneVoiceActive()
+    {
+        return numberOfActiveVoices > 0;
+    }
+
+    bool VoiceManager::isNoteAlreadyPressed (int note)
     {
-        for (auto& voice : voices)
+        return getVoiceForNote (note) != none;
+    }
+
+    void VoiceManager::pushBack (VoiceList& list, int voice)
+    {
+        VoiceController& v = voices[voice];
+        v.previous = list.tail;
+        v.next = none;
+
+        if (list.tail != none) voices[list.tail].next = voice;
+        else list.head = voice;
+
+        list.tail = voice;
+    }
+
+    void VoiceManager::remove (VoiceList& list, int voice)
+    {
+        VoiceController& v = voices[voice];
+
+        if (v.previous != none) voices[v.previous].next = v.next;
+        else list.head = v.next;
+
+        if (v.next != none) voices[v.next].previous = v.previous;
+        else list.tail = v.previous;
+
+        v.previous = none;
+        v.next = none;
+    }
+
+    int VoiceManager::findVoiceToSteal() const
+    {
+        switch (stealingPolicy)
         {
-            if (voice.note == message.note && voice.active)
+            case StealingPolicy::None:
+                return none;
+
+            case StealingPolicy::Oldest:
+                return activeVoices.head;
+
+            case StealingPolicy::Quietest:
             {
-                voice.active = false;
-                voice.noteOff_out.fire (message);
+                // Levels change every block, so they are compared only when a voice has to be stolen.
+                // Walking from the oldest voice breaks ties in its favour.
+                int quietest = activeVoices.head;
+                for (int i = activeVoices.head; i != none; i = voices[i].next)
+                {
+                    if (voices[i].level < voices[quietest].level)
+                        quietest = i;
+                }
+                return quietest;
             }
         }
+        return none;
+    }
+
+    int VoiceManager::findFreeVoice() const
+    {
+        // Lowest-numbered silent voice, so sounding voices stay packed into few SIMD groups
+        for (int w = 0; w < static_cast<int> (soundingVoices.size()); w++)
+        {
+            const int voice = w * 64 + std::countr_one (soundingVoices[w]);
+            if (voice < w * 64 + 64 && voice < getNumberOfVoices()) return voice;
+        }
+
+        // Otherwise the voice released longest ago has had the most time to finish its tail
+        return freeVoices.head;
+    }
+
+    void VoiceManager::releaseVoice (int voice, unsigned char velocity)
+    {
+        VoiceController& v = voices[voice];
+
+        remove (activeVoices, voice);
+        pushBack (freeVoices, voice);
+        numberOfActiveVoices--;
+
+        v.state = VoiceState::Releasing;
+        noteToVoice[v.note] = none;
+        v.noteOff_out.fire ({   .channel = v.channel, .note = v.note, .velocity = velocity   });
+    }
+
+    void VoiceManager::handleNoteOn (const Midi::MessageNoteOn message)
+    {
+        if (message.note > 127) return;
+
+        if (const int playing = noteToVoice[message.note]; playing != none)
+        {
+            if (!retriggerSameNote) return;
+
+            VoiceController& voice = voices[playing];
+            remove (activeVoices, playing);
+            pushBack (activeVoices, playing);
+
+            voice.channel = message.channel;
+            voice.noteOn_out.fire (message);
+            return;
+        }
+
+        if (freeVoices.head == none)
+        {
+            const int stolen = findVoiceToSteal();
+            if (stolen == none) return;
+
+            releaseVoice (stolen, 0);
+        }
+
+        const int index = findFreeVoice();
+        VoiceController& voice = voices[index];
+
+        remove (freeVoices, index);
+        pushBack (activeVoices, index);
+        numberOfActiveVoices++;
+
+        voice.state = VoiceState::Active;
+        setSounding (index, true);
+        voice.note = message.note;
+        voice.channel = message.channel;
+        noteToVoice[message.note] = index;
+
+        voice.noteOn_out.fire (message);
+    }
+
+    void VoiceManager::handleNoteOff (const Midi::MessageNoteOff message)
+    {
+        const int voice = getVoiceForNote (message.note);
+        if (voice == none) return;
+
+        releaseVoice (voice, message.velocity);
     }
 
     void VoiceManager::handleAllNotesOff (const Midi::MessageAllNotesOff message)
     {
-        for (auto& voice : voices)
+        while (activeVoices.head != none)
         {
-            voice.active = false;
-            voice.noteOff_out.fire ({   .channel = message.channel, .note = voice.note, .velocity = 0   });
+            const int voice = activeVoices.head;
+            voices[voice].channel = message.channel;
+            releaseVoice (voice, 0);
         }
     }
 }
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
 
 #include "Events.h"
 #include "Midi.h"
@@ -8,23 +11,148 @@
 namespace Ath::Control
 {
 
+    /**
+     * @brief Voice allocator that connects with voice objects using horizontal events.
+     *
+     * Note-on and note-off are O(1): a table maps each note to its voice, free
+     * voices wait in a queue in the order they were released and active voices
+     * are kept in the order they were started. Storage is allocated once in the
+     * constructor.
+     *
+     * Every voice goes through Active (note held), Releasing (note released,
+     * tail still ringing) and Silent. A releasing voice turns silent when the
+     * level it reports through setVoiceLevel falls to the silence threshold.
+     * Note-ons take the lowest-numbered silent voice first, and only then the
+     * voice released longest ago, so sounding voices stay packed at the low
+     * indices. Render only the voices from getVoicesToRender(), or for SIMD
+     * voice banks the groups from getGroupsToRender(); the rest are silent.
+     */
     class VoiceManager
     {
+    public:
+        // Any number of callbacks can connect at setup; firing them on the audio thread does not allocate
+        using NoteOnOutput = EventOutput<Midi::MessageNoteOn>;
+        using NoteOffOutput = EventOutput<Midi::MessageNoteOff>;
+
+        /// What to do with a note-on when all voices are active
+        enum class StealingPolicy
+        {
+            None,       // drop the new note
+            Oldest,     // release the voice that was started first
+            Quietest    // release the voice with the lowest level, see setVoiceLevel
+        };
+
+        enum class VoiceState
+        {
+            Silent,
+            Active,
+            Releasing
+        };
+
+    private:
+        static constexpr int none = -1;
+
         struct VoiceController
         {
-            bool active = false;
+            VoiceState state = VoiceState::Silent;
             unsigned char note = 69;
             unsigned char channel = 0;
+            float level = 0.0f;
+
+            // Links in the active or the free list
+            int previous = none;
+            int next = none;
+
+            NoteOnOutput noteOn_out;
+            NoteOffOutput noteOff_out;
+        };
 
-            EventOutput<Midi::MessageNoteOn> noteOn_out;
-            EventOutput<Midi::MessageNoteOff> noteOff_out;
+        struct VoiceList
+        {
+            int head = none;    // oldest
+            int tail = none;    // newest
         };
 
-        std::array<VoiceController, 16> voices;
+        std::vector<VoiceController> voices;
+        std::array<int, 128> noteToVoice;
+
+        VoiceList activeVoices;
+        VoiceList freeVoices;
+        int numberOfActiveVoices = 0;
+
+        // One bit per voice that is not silent
+        std::vector<uint64_t> soundingVoices;
+        float silenceThreshold = 1.0e-4f;
+
+        std::vector<int> voicesToRender;
+        int numberOfVoicesToRender = 0;
+        bool voicesToRenderChanged = true;
+
+        std::vector<int> groupsToRender;
+
+        StealingPolicy stealingPolicy = StealingPolicy::None;
+        bool retriggerSameNote = false;
+
+        void pushBack (VoiceList& list, int voice);
+        void remove (VoiceList& list, int voice);
+
+        int findVoiceToSteal() const;
+        int findFreeVoice() const;
+        void releaseVoice (int voice, unsigned char velocity);
+
+        void setSounding (int voice, bool sounding);
 
     public:
-        EventOutput<Midi::MessageNoteOn>& noteOn_out (int i);
-        EventOutput<Midi::MessageNoteOff>& noteOff_out (int i);
+        explicit VoiceManager (int numberOfVoices = 16);
+
+        NoteOnOutput& noteOn_out (int i);
+        NoteOffOutput& noteOff_out (int i);
+
+        int getNumberOfVoices() const;
+        int getNumberOfActiveVoices() const;
+
+        void setStealingPolicy (StealingPolicy policy);
+        StealingPolicy getStealingPolicy() const;
+
+        /**
+         * @brief With retrigger on, a note-on for a note that is already playing
+         * fires noteOn again on the same voice. Otherwise the note-on is ignored.
+         */
+        void setRetriggerSameNote (bool shouldRetrigger);
+        bool getRetriggerSameNote() const;
+
+        /**
+         * @brief Report the current output level of a voice, e.g. its envelope value, for StealingPolicy::Quietest.
+         */
+        void setVoiceLevel (int i, float level);
+
+        /**
+         * @param threshold Level at or below which a releasing voice turns silent (default 1e-4, -80 dB)
+         */
+        void setSilenceThreshold (float threshold);
+        float getSilenceThreshold() const;
+
+        VoiceState getVoiceState (int i) const;
+
+        /**
+         * @return Indices of the voices that are not silent, ascending. Valid until the next note or level change.
+         */
+        std::span<const int> getVoicesToRender();
+
+        int getNumberOfVoicesToRender();
+
+        /**
+         * @brief Groups of voicesPerGroup consecutive voices with at least one voice that is not silent, ascending.
+         *
+         * For SIMD voice banks where voice i is lane i % lanes of group i / lanes.
+         * Valid until the next call.
+         */
+        std::span<const int> getGroupsToRender (int voicesPerGroup);
+
+        /**
+         * @return index of the voice playing a note, or -1
+         */
+        int getVoiceForNote (int note) const;
 
         bool isAtLeastOneVoiceActive();
 
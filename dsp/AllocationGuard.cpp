@@ -0,0 +1,99 @@
+#include "AllocationGuard.h"
+
+#if ATH_DSP_DETECT_ALLOCATIONS
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace Ath::Dsp
+{
+
+    namespace
+    {
+        thread_local int noAllocationDepth = 0;
+
+        void abortOnAllocation (std::size_t bytes)
+        {
+            std::fprintf (stderr, "ath_dsp: heap allocation of %zu bytes on a real-time thread\n", bytes);
+            std::abort();
+        }
+
+        AllocationHandler allocationHandler = abortOnAllocation;
+
+        void check (std::size_t bytes)
+        {
+            if (noAllocationDepth > 0)
+            {
+                // The handler may allocate itself, e.g. to log
+                noAllocationDepth = -noAllocationDepth;
+                allocationHandler (bytes);
+                noAllocationDepth = -noAllocationDepth;
+            }
+        }
+
+        void* allocate (std::size_t bytes)
+        {
+            check (bytes);
+
+            void* pointer = std::malloc (bytes ? bytes : 1);
+            if (!pointer) throw std::bad_alloc();
+            return pointer;
+        }
+
+        void* allocateAligned (std::size_t bytes, std::align_val_t alignment)
+        {
+            check (bytes);
+
+            const auto align = static_cast<std::size_t> (alignment);
+        #if defined(_MSC_VER)
+            void* pointer = _aligned_malloc (bytes ? bytes : 1, align);
+        #else
+            void* pointer = std::aligned_alloc (align, (std::max<std::size_t> (bytes, 1) + align - 1) / align * align);
+        #endif
+            if (!pointer) throw std::bad_alloc();
+            return pointer;
+        }
+
+        void freeAligned (void* pointer)
+        {
+        #if defined(_MSC_VER)
+            _aligned_free (pointer);
+        #else
+            std::free (pointer);
+        #endif
+        }
+    }
+
+    void setAllocationHandler (AllocationHandler handler) { allocationHandler = handler ? handler : abortOnAllocation; }
+
+    ScopedNoAllocation::ScopedNoAllocation() { noAllocationDepth++; }
+    ScopedNoAllocation::~ScopedNoAllocation() { noAllocationDepth--; }
+}
+
+void* operator new (std::size_t bytes) { return Ath::Dsp::allocate (bytes); }
+void* operator new[] (std::size_t bytes) { return Ath::Dsp::allocate (bytes); }
+void* operator new (std::size_t bytes, std::align_val_t alignment) { return Ath::Dsp::allocateAligned (bytes, alignment); }
+void* operator new[] (std::size_t bytes, std::align_val_t alignment) { return Ath::Dsp::allocateAligned (bytes, alignment); }
+
+void* operator new (std::size_t bytes, const std::nothrow_t&) noexcept
+{
+    try { return Ath::Dsp::allocate (bytes); } catch (...) { return nullptr; }
+}
+
+void* operator new[] (std::size_t bytes, const std::nothrow_t&) noexcept
+{
+    try { return Ath::Dsp::allocate (bytes); } catch (...) { return nullptr; }
+}
+
+void operator delete (void* pointer) noexcept { std::free (pointer); }
+void operator delete[] (void* pointer) noexcept { std::free (pointer); }
+void operator delete (void* pointer, std::size_t) noexcept { std::free (pointer); }
+void operator delete[] (void* pointer, std::size_t) noexcept { std::free (pointer); }
+void operator delete (void* pointer, std::align_val_t) noexcept { Ath::Dsp::freeAligned (pointer); }
+void operator delete[] (void* pointer, std::align_val_t) noexcept { Ath::Dsp::freeAligned (pointer); }
+void operator delete (void* pointer, std::size_t, std::align_val_t) noexcept { Ath::Dsp::freeAligned (pointer); }
+void operator delete[] (void* pointer, std::size_t, std::align_val_t) noexcept { Ath::Dsp::freeAligned (pointer); }
+
+#endif
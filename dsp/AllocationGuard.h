@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * Debug detection of heap allocations on the audio thread, compiled in with
+ * ATH_DSP_DETECT_ALLOCATIONS=1 (the ATH_DSP_DETECT_ALLOCATIONS CMake option).
+ * It replaces the global operator new and delete, so it is meant for debug
+ * builds only. Allocations through malloc directly are not seen.
+ */
+#ifndef ATH_DSP_DETECT_ALLOCATIONS
+#define ATH_DSP_DETECT_ALLOCATIONS 0
+#endif
+
+namespace Ath::Dsp
+{
+    /**
+     * @brief Called for an allocation of this many bytes inside a ScopedNoAllocation.
+     */
+    using AllocationHandler = void (*) (std::size_t bytes);
+
+#if ATH_DSP_DETECT_ALLOCATIONS
+    /**
+     * @brief Replace the default handler, which prints the size and aborts. Not thread-safe, call at startup.
+     */
+    void setAllocationHandler (AllocationHandler handler);
+
+    /**
+     * @brief Marks the current thread as real-time for its lifetime: any operator new inside calls the allocation handler.
+     *
+     * Scopes nest. MidiAudioProcessor::process opens one.
+     */
+    class ScopedNoAllocation
+    {
+    public:
+        ScopedNoAllocation();
+        ~ScopedNoAllocation();
+
+        ScopedNoAllocation (const ScopedNoAllocation&) = delete;
+        ScopedNoAllocation& operator= (const ScopedNoAllocation&) = delete;
+    };
+#else
+    inline void setAllocationHandler (AllocationHandler) {}
+
+    class ScopedNoAllocation
+    {
+    public:
+        // User-provided, so an unused guard does not warn
+        ScopedNoAllocation() {}
+
+        ScopedNoAllocation (const ScopedNoAllocation&) = delete;
+        ScopedNoAllocation& operator= (const ScopedNoAllocation&) = delete;
+    };
+#endif
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+#include "Filter.h"
+#include "../math/Simd.h"
+
+namespace Ath::Dsp::Filter::Biquad
+{
+    namespace Detail
+    {
+        /// Vector of N float lanes; float8 is only named where it exists
+        template <int N>
+        struct BiquadBankVector { using Type = Simd::float4; };
+
+    #if SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX2
+        template <>
+        struct BiquadBankVector<8> { using Type = Simd::float8; };
+    #endif
+    }
+
+    /**
+     * @brief Bank of N independent biquads processed together in one SIMD register.
+     *
+     * Every lane is a separate filter with its own state. Coefficients are kept
+     * in SoA layout (one vector per coefficient), so lanes can share the same
+     * coefficients (channel-parallel use, e.g. one EQ over 8 channels) or carry
+     * their own (voice-parallel use, e.g. one filter per voice).
+     *
+     * @tparam N Number of lanes: 4 (float4) or, from AVX2 on, 8 (float8)
+     * @tparam Topology Any of the four BiquadTopology variants
+     */
+    template <int N, BiquadTopology Topology = BiquadTopology::TransposedDirectForm2>
+    class BiquadBank
+    {
+    #if SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX2
+        static_assert(N == 4 || N == 8, "BiquadBank supports 4 or 8 lanes");
+    #else
+        static_assert(N == 4, "BiquadBank supports 4 lanes; 8 lanes need AVX2");
+    #endif
+
+    public:
+        using VectorType = typename Detail::BiquadBankVector<N>::Type;
+
+        static constexpr int numberOfLanes = N;
+
+    private:
+        Biquad<VectorType, Topology> biquad;
+
+        // Scalar copy of the per-lane coefficients, used to rebuild vectors on lane updates
+        alignas(32) std::array<float, N> b0, b1, b2, a0, a1, a2;
+
+        void updateVectors()
+        {
+            biquad.setCoefficients({ VectorType(b0.data()), VectorType(b1.data()), VectorType(b2.data()),
+                                     VectorType(a0.data()), VectorType(a1.data()), VectorType(a2.data()) });
+        }
+
+    public:
+        BiquadBank()
+        {
+            setCoefficients(DigitalBiquadCoefficients<float>());
+        }
+
+        void reset() { biquad.reset(); }
+
+        /**
+         * @brief Set the same coefficients for all lanes (channel-parallel use).
+         */
+        void setCoefficients(const DigitalBiquadCoefficients<float>& c)
+        {
+            b0.fill(c.b0); b1.fill(c.b1); b2.fill(c.b2);
+            a0.fill(c.a0); a1.fill(c.a1); a2.fill(c.a2);
+
+            biquad.setCoefficients({ VectorType(c.b0), VectorType(c.b1), VectorType(c.b2),
+                                     VectorType(c.a0), VectorType(c.a1), VectorType(c.a2) });
+        }
+
+        /**
+         * @brief Set coefficients of a single lane (voice-parallel use).
+         *
+         * @param lane Lane index in 0..N-1
+         * @param c Coefficients for that lane
+         */
+        void setCoefficients(int lane, const DigitalBiquadCoefficients<float>& c)
+        {
+            b0[lane] = c.b0; b1[lane] = c.b1; b2[lane] = c.b2;
+            a0[lane] = c.a0; a1[lane] = c.a1; a2[lane] = c.a2;
+
+            updateVectors();
+        }
+
+        /**
+         * @brief Set coefficients of all lanes at once from an array of per-lane values.
+         */
+        void setCoefficients(const std::array<DigitalBiquadCoefficients<float>, N>& c)
+        {
+            for (int lane = 0; lane < N; lane++)
+            {
+                b0[lane] = c[lane].b0; b1[lane] = c[lane].b1; b2[lane] = c[lane].b2;
+                a0[lane] = c[lane].a0; a1[lane] = c[lane].a1; a2[lane] = c[lane].a2;
+            }
+
+            updateVectors();
+        }
+
+        /**
+         * @brief Set SoA coefficients directly, one vector per coefficient.
+         */
+        void setCoefficients(const DigitalBiquadCoefficients<VectorType>& c)
+        {
+            c.b0.store(b0.data()); c.b1.store(b1.data()); c.b2.store(b2.data());
+            c.a0.store(a0.data()); c.a1.store(a1.data()); c.a2.store(a2.data());
+
+            biquad.setCoefficients(c);
+        }
+
+        DigitalBiquadCoefficients<float> getCoefficients(int lane) const
+        {
+            return { b0[lane], b1[lane], b2[lane], a0[lane], a1[lane], a2[lane] };
+        }
+
+        /**
+         * @brief Process one frame, one sample per lane.
+         */
+        inline VectorType process(VectorType x) { return biquad.process(x); }
+
+        inline VectorType last() { return biquad.last(); }
+
+        /**
+         * @brief Process n frames stored lane-interleaved (one vector per frame).
+         */
+        void processBlock(const VectorType* in, VectorType* out, int n) { biquad.processBlock(in, out, n); }
+
+        void processBlock(VectorType* buffer, int n) { biquad.processBlock(buffer, buffer, n); }
+
+        /**
+         * @brief Process non-interleaved channels, one channel per lane.
+         *
+         * Channels are transposed into lane-interleaved tiles of 64 frames on
+         * the stack, filtered with the vector block loop and
+         * transposed back, so every channel is read and written contiguously.
+         * Lanes beyond numberOfChannels are fed with silence.
+         *
+         * @param in Input channel pointers
+         * @param out Output channel pointers (may alias in)
+         * @param numberOfChannels Number of channels, at most N
+         * @param n Number of samples per channel
+         */
+        void processBlock(const float* const* in, float* const* out, int numberOfChannels, int n)
+        {
+            constexpr int tileSize = 64;
+
+            std::array<VectorType, tileSize> tileIn, tileOut;
+            std::fill(tileIn.begin(), tileIn.end(), VectorType(0.0f));
+
+            float* const interleavedIn = reinterpret_cast<float*>(tileIn.data());
+            const float* const interleavedOut = reinterpret_cast<const float*>(tileOut.data());
+
+            for (int start = 0; start < n; start += tileSize)
+            {
+                const int frames = std::min(tileSize, n - start);
+
+                for (int ch = 0; ch < numberOfChannels; ch++)
+                {
+                    const float* channel = in[ch] + start;
+                    for (int i = 0; i < frames; i++) interleavedIn[i * N + ch] = channel[i];
+                }
+
+                biquad.processBlock(tileIn.data(), tileOut.data(), frames);
+
+                for (int ch = 0; ch < numberOfChannels; ch++)
+                {
+                    float* channel = out[ch] + start;
+                    for (int i = 0; i < frames; i++) channel[i] = interleavedOut[i * N + ch];
+                }
+            }
+        }
+    };
+}
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <numbers>
+#include <unordered_map>
+
+#include "Filter.h"
+#include "../math/Math.h"
+
+namespace Ath::Dsp::Filter::Biquad
+{
+    /**
+     * @brief Response types of the RBJ Audio EQ Cookbook designers.
+     */
+    enum class BiquadType
+    {
+        LowPass,
+        HighPass,
+        Peak,
+        LowShelf,
+        HighShelf
+    };
+
+    /**
+     * @brief Analog frequency, in rad/s, that the bilinear transform maps to freq.
+     *
+     * Use it for the cutoff of an analog prototype before bilinear(), so the
+     * digital filter has its corner exactly at freq.
+     */
+    static constexpr double prewarp(double freq, double sr)
+    {
+        return 2.0 * sr * Math::Constexpr::tan(std::numbers::pi * freq / sr);
+    }
+
+    /**
+     * @brief RBJ cookbook biquad, normalised to a0 = 1.
+     *
+     * Designed in double and constexpr, so fixed stages (DC blockers,
+     * de-emphasis, tone stacks at a known rate) can be constants:
+     *
+     *     static constexpr auto dcBlocker = design<float>(BiquadType::HighPass, 10.0, 0.707, 0.0, 48000.0);
+     *
+     * @param freq Cutoff or centre frequency in Hz, below sr / 2
+     * @param q Quality factor; for shelves, 0.707 gives the steepest slope without overshoot
+     * @param gainDb Gain of Peak and shelf types, ignored by LowPass and HighPass
+     * @param sr Sample rate in Hz
+     */
+    template <typename T>
+    static constexpr DigitalBiquadCoefficients<T> design(BiquadType type, double freq, double q, double gainDb, double sr)
+    {
+        const double w0 = 2.0 * std::numbers::pi * freq / sr;
+        const double cosW0 = Math::Constexpr::cos(w0);
+        const double alpha = Math::Constexpr::sin(w0) / (2.0 * q);
+        const double A = Math::Constexpr::pow10(gainDb / 40.0);
+
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a0 = 1.0, a1 = 0.0, a2 = 0.0;
+
+        switch (type)
+        {
+            case BiquadType::LowPass:
+                b1 = 1.0 - cosW0;
+                b0 = b1 * 0.5;
+                b2 = b0;
+                a0 = 1.0 + alpha;
+                a1 = -2.0 * cosW0;
+                a2 = 1.0 - alpha;
+                break;
+
+            case BiquadType::HighPass:
+                b1 = -(1.0 + cosW0);
+                b0 = -b1 * 0.5;
+                b2 = b0;
+                a0 = 1.0 + alpha;
+                a1 = -2.0 * cosW0;
+                a2 = 1.0 - alpha;
+                break;
+
+            case BiquadType::Peak:
+                b0 = 1.0 + alpha * A;
+                b1 = -2.0 * cosW0;
+                b2 = 1.0 - alpha * A;
+                a0 = 1.0 + alpha / A;
+                a1 = -2.0 * cosW0;
+                a2 = 1.0 - alpha / A;
+                break;
+
+            case BiquadType::LowShelf:
+            {
+                const double k = 2.0 * Math::Constexpr::sqrt(A) * alpha;
+                b0 = A * ((A + 1.0) - (A - 1.0) * cosW0 + k);
+                b1 = 2.0 * A * ((A - 1.0) - (A + 1.0) * cosW0);
+                b2 = A * ((A + 1.0) - (A - 1.0) * cosW0 - k);
+                a0 = (A + 1.0) + (A - 1.0) * cosW0 + k;
+                a1 = -2.0 * ((A - 1.0) + (A + 1.0) * cosW0);
+                a2 = (A + 1.0) + (A - 1.0) * cosW0 - k;
+                break;
+            }
+
+            case BiquadType::HighShelf:
+            {
+                const double k = 2.0 * Math::Constexpr::sqrt(A) * alpha;
+                b0 = A * ((A + 1.0) + (A - 1.0) * cosW0 + k);
+                b1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cosW0);
+                b2 = A * ((A + 1.0) + (A - 1.0) * cosW0 - k);
+                a0 = (A + 1.0) - (A - 1.0) * cosW0 + k;
+                a1 = 2.0 * ((A - 1.0) - (A + 1.0) * cosW0);
+                a2 = (A + 1.0) - (A - 1.0) * cosW0 - k;
+                break;
+            }
+        }
+
+        DigitalBiquadCoefficients<T> coeffs;
+        coeffs.b0 = static_cast<T>(b0 / a0);
+        coeffs.b1 = static_cast<T>(b1 / a0);
+        coeffs.b2 = static_cast<T>(b2 / a0);
+        coeffs.a0 = T(1.0);
+        coeffs.a1 = static_cast<T>(a1 / a0);
+        coeffs.a2 = static_cast<T>(a2 / a0);
+        return coeffs;
+    }
+
+    template <typename T>
+    static constexpr DigitalBiquadCoefficients<T> designLowPass(double freq, double q, double sr) { return design<T>(BiquadType::LowPass, freq, q, 0.0, sr); }
+
+    template <typename T>
+    static constexpr DigitalBiquadCoefficients<T> designHighPass(double freq, double q, double sr) { return design<T>(BiquadType::HighPass, freq, q, 0.0, sr); }
+
+    template <typename T>
+    static constexpr DigitalBiquadCoefficients<T> designPeak(double freq, double q, double gainDb, double sr) { return design<T>(BiquadType::Peak, freq, q, gainDb, sr); }
+
+    template <typename T>
+    static constexpr DigitalBiquadCoefficients<T> designLowShelf(double freq, double q, double gainDb, double sr) { return design<T>(BiquadType::LowShelf, freq, q, gainDb, sr); }
+
+    template <typename T>
+    static constexpr DigitalBiquadCoefficients<T> designHighShelf(double freq, double q, double gainDb, double sr) { return design<T>(BiquadType::HighShelf, freq, q, gainDb, sr); }
+
+    /**
+     * @brief Shared store of designed coefficients, keyed by (type, freq, Q, gain, sample rate).
+     *
+     * Many instances of the same patch then design each fixed stage once per
+     * sample rate instead of once per instance. Lookups lock a mutex, so use it
+     * from setContext() and parameter changes, not per sample; and for stages
+     * with fixed settings, since every distinct setting adds an entry. The
+     * cache is cleared when it reaches its maximum size.
+     */
+    class BiquadDesignCache
+    {
+        struct Key
+        {
+            BiquadType type;
+            float freq, q, gainDb, sr;
+
+            bool operator==(const Key& other) const
+            {
+                return type == other.type && freq == other.freq && q == other.q && gainDb == other.gainDb && sr == other.sr;
+            }
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const
+            {
+                const float fields[] = { key.freq, key.q, key.gainDb, key.sr };
+
+                uint64_t h = static_cast<uint64_t>(key.type) + 0x9e3779b97f4a7c15ull;
+                for (float f : fields)
+                {
+                    uint32_t bits;
+                    std::memcpy(&bits, &f, sizeof(bits));
+                    h = (h ^ bits) * 0x100000001b3ull;
+                }
+                return static_cast<size_t>(h ^ (h >> 32));
+            }
+        };
+
+        std::unordered_map<Key, DigitalBiquadCoefficients<float>, KeyHash> entries;
+        mutable std::mutex mutex;
+        size_t maximumSize = 4096;
+
+    public:
+        /**
+         * @brief Coefficients of design<float>() for these settings, designed on the first request.
+         */
+        DigitalBiquadCoefficients<float> get(BiquadType type, float freq, float q, float gainDb, float sr)
+        {
+            // Gain does not change LowPass and HighPass, do not split their entries by it
+            if (type == BiquadType::LowPass || type == BiquadType::HighPass) gainDb = 0.0f;
+
+            const Key key { type, freq, q, gainDb, sr };
+
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (const auto it = entries.find(key); it != entries.end()) return it->second;
+
+            if (entries.size() >= maximumSize) entries.clear();
+
+            const auto coeffs = design<float>(type, freq, q, gainDb, sr);
+            entries.emplace(key, coeffs);
+            return coeffs;
+        }
+
+        void setMaximumSize(size_t numberOfEntries)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            maximumSize = numberOfEntries > 0 ? numberOfEntries : 1;
+        }
+
+        size_t size() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return entries.size();
+        }
+
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            entries.clear();
+        }
+
+        /**
+         * @brief Process-wide cache.
+         */
+        static BiquadDesignCache& getShared()
+        {
+            static BiquadDesignCache cache;
+            return cache;
+        }
+    };
+}
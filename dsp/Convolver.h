@@ -0,0 +1,208 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "FIR.h"
+#include "../math/Complex.h"
+#include "../math/Fft.h"
+
+namespace Ath::Dsp::Filter::Fir
+{
+    /**
+     * @brief Uniformly partitioned FFT convolver (overlap-save).
+     *
+     * The kernel is split into partitions of B samples, each transformed once
+     * in setCoefficients(). Processing costs one FFT/IFFT pair of size 2B per B
+     * input samples plus a spectral multiply-accumulate per partition, instead
+     * of O(N) multiplications per sample of the direct form.
+     *
+     * Latency equals the partition size B. In zero-latency mode the first B taps
+     * run as a direct-form FIR and the FFT engine only convolves the rest of the
+     * kernel, whose inherent delay of B samples is exactly hidden by the head.
+     */
+    class Convolver
+    {
+        int partitionSize = 0;         // B
+        int numberOfBins = 0;          // B + 1
+        int numberOfPartitions = 0;    // P
+
+        bool zeroLatency = false;
+        bool useHead = false;          // zero latency with at least one head tap
+
+        Math::Fft fft;
+
+        // Kernel spectra, P partitions of B + 1 bins each
+        std::vector<Math::ComplexBuffer> kernel;
+
+        // Frequency-domain delay line of input spectra, same layout as kernel
+        std::vector<Math::ComplexBuffer> delayLine;
+        int delayLinePosition = 0;
+
+        Math::ComplexBuffer accumulator;
+
+        std::vector<float> inputWindow;    // 2B: previous block followed by the block being filled
+        std::vector<float> outputBlock;    // B samples of the last computed block
+        std::vector<float> timeScratch;    // 2B
+
+        int fifoPosition = 0;
+
+        Filter<float> head;
+        std::vector<float> headScratch;
+
+        void processPartition()
+        {
+            Math::ComplexBuffer& spectrum = delayLine[delayLinePosition];
+            fft.forwardReal(inputWindow.data(), spectrum.real(), spectrum.imag());
+
+            accumulator.clear();
+
+            for (int p = 0; p < numberOfPartitions; p++)
+            {
+                int slot = delayLinePosition - p;
+                if (slot < 0) slot += numberOfPartitions;
+
+                accumulator.multiplyAccumulate(kernel[p], delayLine[slot]);
+            }
+
+            fft.inverseReal(accumulator.real(), accumulator.imag(), timeScratch.data());
+
+            // Overlap-save: the second half holds the valid linear convolution
+            std::copy(timeScratch.begin() + partitionSize, timeScratch.end(), outputBlock.begin());
+
+            // Slide the input window by one block
+            std::copy(inputWindow.begin() + partitionSize, inputWindow.end(), inputWindow.begin());
+
+            if (++delayLinePosition == numberOfPartitions) delayLinePosition = 0;
+        }
+
+    public:
+        /**
+         * @brief Set the kernel and partitioning.
+         *
+         * Allocates all internal memory; must not be called from the audio thread.
+         *
+         * @param coefficients Impulse response, e.g. from WindowedSincLowpass()
+         * @param newPartitionSize Partition size B, rounded up to a power of two (min 16).
+         *        Sets the latency when zero-latency mode is off.
+         * @param useZeroLatency Run the first B taps in direct form to remove the latency
+         */
+        template <typename T>
+        void setCoefficients(const std::vector<T>& coefficients, int newPartitionSize, bool useZeroLatency = false)
+        {
+            partitionSize = 16;
+            while (partitionSize < newPartitionSize) partitionSize *= 2;
+
+            zeroLatency = useZeroLatency;
+
+            const int B = partitionSize;
+            const int length = static_cast<int>(coefficients.size());
+
+            // In zero-latency mode the head covers taps [0, B), the FFT engine the rest
+            const int tailStart = zeroLatency ? std::min(B, length) : 0;
+            const int tailLength = length - tailStart;
+
+            // An empty kernel has no head taps, and a 0-tap FIR must not run
+            useHead = tailStart > 0;
+
+            if (useHead)
+            {
+                head.setCoefficients(std::vector<float>(coefficients.begin(), coefficients.begin() + tailStart));
+                headScratch.resize(B);
+            }
+
+            numberOfPartitions = std::max(1, (tailLength + B - 1) / B);
+
+            fft.setSize(2 * B);
+            numberOfBins = fft.getNumberOfBins();
+
+            kernel.resize(numberOfPartitions);
+
+            timeScratch.assign(2 * B, 0.0f);
+
+            for (int p = 0; p < numberOfPartitions; p++)
+            {
+                std::fill(timeScratch.begin(), timeScratch.end(), 0.0f);
+
+                for (int i = 0; i < B; i++)
+                {
+                    const int tap = tailStart + p * B + i;
+                    if (tap < length) timeScratch[i] = static_cast<float>(coefficients[tap]);
+                }
+
+                kernel[p].resize(numberOfBins);
+                fft.forwardReal(timeScratch.data(), kernel[p].real(), kernel[p].imag());
+            }
+
+            delayLine.resize(numberOfPartitions);
+            for (auto& spectrum : delayLine) spectrum.resize(numberOfBins);
+            accumulator.resize(numberOfBins);
+            inputWindow.resize(2 * B);
+            outputBlock.resize(B);
+
+            reset();
+        }
+
+        void reset()
+        {
+            for (auto& spectrum : delayLine) spectrum.clear();
+            std::fill(inputWindow.begin(), inputWindow.end(), 0.0f);
+            std::fill(outputBlock.begin(), outputBlock.end(), 0.0f);
+
+            delayLinePosition = 0;
+            fifoPosition = 0;
+
+            if (useHead) head.reset();
+        }
+
+        /** @return Latency in samples: the partition size, or 0 in zero-latency mode */
+        int getLatency() const { return zeroLatency ? 0 : partitionSize; }
+
+        int getPartitionSize() const { return partitionSize; }
+
+        /**
+         * @brief Convolve a block of samples. Block size is independent of the partition size.
+         *
+         * @param in Input samples
+         * @param out Output samples (may alias in)
+         * @param n Number of samples
+         */
+        void processBlock(const float* in, float* out, int n)
+        {
+            const int B = partitionSize;
+
+            int done = 0;
+            while (done < n)
+            {
+                const int chunk = std::min(n - done, B - fifoPosition);
+
+                const float* chunkIn = in + done;
+                float* chunkOut = out + done;
+
+                if (useHead)
+                {
+                    for (int i = 0; i < chunk; i++) headScratch[i] = head.process(chunkIn[i]);
+                }
+
+                std::copy(chunkIn, chunkIn + chunk, inputWindow.begin() + B + fifoPosition);
+                std::copy(outputBlock.begin() + fifoPosition, outputBlock.begin() + fifoPosition + chunk, chunkOut);
+
+                if (useHead)
+                {
+                    for (int i = 0; i < chunk; i++) chunkOut[i] += headScratch[i];
+                }
+
+                fifoPosition += chunk;
+                done += chunk;
+
+                if (fifoPosition == B)
+                {
+                    processPartition();
+                    fifoPosition = 0;
+                }
+            }
+        }
+
+        void processBlock(float* buffer, int n) { processBlock(buffer, buffer, n); }
+    };
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #include <xmmintrin.h>
+    #define ATH_DSP_DENORMALS_X86 1
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+    #define ATH_DSP_DENORMALS_AARCH64 1
+#endif
+
+namespace Ath::Dsp
+{
+    /**
+     * @brief Flush denormals to zero in the current thread for the lifetime of the object.
+     *
+     * Sets FTZ and DAZ in MXCSR on x86, FZ in FPCR on AArch64, and restores the
+     * previous mode on destruction. Recursive filters decaying toward zero
+     * otherwise end up in the denormal range after note-off, where every
+     * operation takes a slow microcode path. The mode is per thread, so worker
+     * threads need their own instance. A no-op on other targets.
+     */
+    class ScopedFlushDenormals
+    {
+    #if ATH_DSP_DENORMALS_X86
+        static constexpr unsigned int flushToZero = 0x8000;
+        static constexpr unsigned int denormalsAreZero = 0x0040;
+
+        unsigned int previous;
+    #elif ATH_DSP_DENORMALS_AARCH64
+        static constexpr uint64_t flushToZero = uint64_t(1) << 24;
+
+        uint64_t previous;
+    #endif
+
+    public:
+        ScopedFlushDenormals()
+        {
+        #if ATH_DSP_DENORMALS_X86
+            previous = _mm_getcsr();
+            _mm_setcsr(previous | flushToZero | denormalsAreZero);
+        #elif ATH_DSP_DENORMALS_AARCH64
+            __asm__ __volatile__ ("mrs %0, fpcr" : "=r" (previous));
+            __asm__ __volatile__ ("msr fpcr, %0" : : "r" (previous | flushToZero));
+        #endif
+        }
+
+        ~ScopedFlushDenormals()
+        {
+        #if ATH_DSP_DENORMALS_X86
+            _mm_setcsr(previous);
+        #elif ATH_DSP_DENORMALS_AARCH64
+            __asm__ __volatile__ ("msr fpcr, %0" : : "r" (previous));
+        #endif
+        }
+
+        ScopedFlushDenormals(const ScopedFlushDenormals&) = delete;
+        ScopedFlushDenormals& operator=(const ScopedFlushDenormals&) = delete;
+    };
+
+    /**
+     * Level (-200 dB) below which the state and input of a recursive filter
+     * count as silence, see isSilent().
+     */
+    template <typename T>
+    inline constexpr T quiescenceThreshold = T(1.0e-10);
+
+    /**
+     * @brief Quiescence detection: check whether a filter state and a block of input are all below quiescenceThreshold.
+     *
+     * A linear filter for which this holds can skip the block, output zeros
+     * and clear its state. The state is checked first and any sample above the
+     * threshold ends the scan, so a running filter pays almost nothing.
+     * Always false for SIMD types, whose lanes may be independent voices.
+     */
+    template <typename T>
+    inline bool isSilent(const T* in, int n, std::initializer_list<T> state)
+    {
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            const T threshold = quiescenceThreshold<T>;
+
+            for (const T s : state)
+                if (!(std::abs(s) <= threshold)) return false;
+
+            for (int i = 0; i < n; i++)
+                if (!(std::abs(in[i]) <= threshold)) return false;
+
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+}
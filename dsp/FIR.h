@@ -1,61 +1,139 @@
 #pragma once
 
+#include <array>
 #include <cmath>
 #include <cstddef>
+#include <numbers>
 #include <vector>
 #include <algorithm>
 
+#include "../math/Math.h"
+
 namespace Ath::Dsp::Filter::Fir
 {
     /**
-     * @brief Computes coefficients for a linear-phase low-pass filter. 
+     * @brief Cosine-sum windows for WindowedSincLowpass().
+     */
+    enum class Window
+    {
+        Rectangular,
+        Hann,
+        Hamming,
+        Blackman,
+        BlackmanNuttall
+    };
+
+    /**
+     * @brief Coefficients of w(n) = a0 - a1 cos(2πn/M) + a2 cos(4πn/M) - a3 cos(6πn/M).
+     */
+    static constexpr std::array<double, 4> getWindowCoefficients(Window window)
+    {
+        switch (window)
+        {
+            case Window::Rectangular:     return { 1.0, 0.0, 0.0, 0.0 };
+            case Window::Hann:            return { 0.5, 0.5, 0.0, 0.0 };
+            case Window::Hamming:         return { 0.54, 0.46, 0.0, 0.0 };
+            case Window::Blackman:        return { 0.42, 0.5, 0.08, 0.0 };
+            case Window::BlackmanNuttall: return { 0.3635819, 0.4891775, 0.1365995, 0.0106411 };
+        }
+        return { 1.0, 0.0, 0.0, 0.0 };
+    }
+
+    /**
+     * @brief Number of taps of a WindowedSincLowpass() kernel: sr * duration, rounded down to an odd number, at least 1.
+     */
+    static size_t WindowedSincLength(double duration, double sr)
+    {
+        size_t N = static_cast<size_t>(std::max(sr * duration, 1.0));
+        if (N % 2 == 0) N -= 1;
+        return N;
+    }
+
+    /**
+     * @brief Computes coefficients for a linear-phase low-pass filter into existing storage.
+     *
+     * The kernel is symmetric, so only half of it is computed. Instead of
+     * calling sin and cos per tap, sin(kωc) and cos(2πk/M) advance by the
+     * Chebyshev recurrence and the higher window terms are Chebyshev
+     * polynomials of the latter. Both are reseeded exactly every 256 taps,
+     * which keeps the rounding drift of the recurrence near double precision.
+     *
+     * @param coefficients N outputs, float or double
+     * @param N Number of taps, odd (see WindowedSincLength())
      * @param cutoff Cutoff frequency in hertz.
-     * @param duration Kernel duration in seconds.
      * @param sr Sample Rate in hertz.
-     * @note Group delay will be duration/2. Kernel size will be sr*duration.
+     * @param window Window applied to the sinc
      */
-    static std::vector<double> WindowedSincLowpass(double cutoff, double duration, double sr)
+    template <typename T>
+    static void WindowedSincLowpass(T* coefficients, size_t N, double cutoff, double sr, Window window = Window::BlackmanNuttall)
     {
-        size_t N = static_cast<size_t>(sr * duration);
-        if (N % 2 == 0) N -= 1;
-        size_t M = N - 1;
+        const size_t half = N / 2;     // centre tap, M / 2
 
         const auto wc = (cutoff / sr) * std::numbers::pi * 2.0;
+        const auto phi = half > 0 ? std::numbers::pi / static_cast<double>(half) : 0.0;     // 2π / M
+
+        // Around the centre, with k = n - M/2, the alternating signs of the window cancel:
+        // w = a0 + a1 cos(kφ) + a2 T2(cos(kφ)) + a3 T3(cos(kφ))
+        const auto a = getWindowCoefficients(window);
 
-        std::vector<double> coefficients(N);
+        const auto cosWc = std::cos(wc);
+        const auto cosPhi = std::cos(phi);
+        constexpr size_t reseedInterval = 256;
 
+        double sinK = 0.0, sinPrevious = 0.0, cosK = 1.0, cosPrevious = 1.0;
         double sum = 0.0;
 
-        for (size_t n = 0; n < N; n++)
+        for (size_t k = 0; k <= half; k++)
         {
-            // Sinus Cardinalis:
-            const auto x = (static_cast<double>(n) - static_cast<double>(M) * 0.5) * wc;
-            const auto sinc = (x == 0) ? 1.0 : std::sin(x) / x;
+            if (k % reseedInterval == 0)
+            {
+                const auto kd = static_cast<double>(k);
+                sinK = std::sin(kd * wc);
+                sinPrevious = std::sin((kd - 1.0) * wc);
+                cosK = std::cos(kd * phi);
+                cosPrevious = std::cos((kd - 1.0) * phi);
+            }
 
-            // Blackman-Nuttall window::
-            constexpr auto a0 = 0.3635819;
-            constexpr auto a1 = 0.4891775;
-            constexpr auto a2 = 0.1365995;
-            constexpr auto a3 = 0.0106411;
+            // Sinus Cardinalis; all ones at a cutoff of 0, which leaves the normalized window:
+            const auto x = static_cast<double>(k) * wc;
+            const auto sinc = (x == 0) ? 1.0 : sinK / x;
 
-            const auto nm = static_cast<double>(n) /  static_cast<double>(M); 
-            const auto wx2 = nm * 2.0 * std::numbers::pi;
-            const auto wx4 = wx2 * 2.0;
-            const auto wx6 = wx2 * 3.0;
+            const auto w = a[0] + a[1] * cosK + a[2] * Math::chebyshev2(cosK) + a[3] * Math::chebyshev3(cosK);
+            const auto h = w * sinc;
 
-            const auto window = a0 - a1 * std::cos(wx2) + a2 * std::cos(wx4) - a3 * std::cos(wx6);
+            coefficients[half + k] = static_cast<T>(h);
+            coefficients[half - k] = static_cast<T>(h);
+            sum += (k == 0) ? h : 2.0 * h;
 
-            coefficients[n] = window * sinc;
+            const auto sinNext = Math::chebyshev_nplus1(cosWc, sinK, sinPrevious);
+            sinPrevious = sinK;
+            sinK = sinNext;
 
-            sum += coefficients[n];
-        }        
+            const auto cosNext = Math::chebyshev_nplus1(cosPhi, cosK, cosPrevious);
+            cosPrevious = cosK;
+            cosK = cosNext;
+        }
 
         // Normalize impulse response:
-        for (auto& c : coefficients)
+        const auto scale = static_cast<T>(1.0 / sum);
+        for (size_t n = 0; n < N; n++)
         {
-            c /= sum;
+            coefficients[n] *= scale;
         }
+    }
 
+    /**
+     * @brief Computes coefficients for a linear-phase low-pass filter. 
+     * @param cutoff Cutoff frequency in hertz.
+     * @param duration Kernel duration in seconds.
+     * @param sr Sample Rate in hertz.
+     * @param window Window applied to the sinc, Blackman-Nuttall by default
+     * @note Group delay will be duration/2. Kernel size will be sr*duration.
+     */
+    static std::vector<double> WindowedSincLowpass(double cutoff, double duration, double sr, Window window = Window::BlackmanNuttall)
+    {
+        std::vector<double> coefficients(WindowedSincLength(duration, sr));
+        WindowedSincLowpass(coefficients.data(), coefficients.size(), cutoff, sr, window);
         return coefficients;
     }
 
@@ -80,6 +158,7 @@ namespace Ath::Dsp::Filter::Fir
         void reset()
         {
             std::fill(buffer.begin(), buffer.end(), 0.0);
+            circularBufferState = 0;
         }
 
         T process(T x)
@@ -98,7 +177,7 @@ namespace Ath::Dsp::Filter::Fir
                 sum += coefficientsData[i] * bufferData[-static_cast<std::ptrdiff_t>(i)];                
             }
 
-            circularBufferState = (circularBufferState + 1) % n;
+            if (++circularBufferState >= static_cast<int>(n)) circularBufferState = 0;
 
             return sum;
         }
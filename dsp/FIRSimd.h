@@ -0,0 +1,285 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "../math/Simd.h"
+#include "FIR.h"
+
+namespace Ath::Dsp::Filter::Fir
+{
+    /**
+     * @brief Direct-form FIR filter vectorized with AVX2/FMA, intended for short kernels.
+     *
+     * Coefficients are stored reversed and zero-padded to a multiple of 8 in
+     * aligned float8 storage, so each output is a plain dot product of the
+     * coefficients with a contiguous window of the doubled history buffer.
+     *
+     * The padding always includes at least 3 leading zero taps. This lets
+     * processBlock() write the next 3 input samples before computing an
+     * output (the slots they overwrite only meet zero coefficients), so 4
+     * outputs are computed per pass over the coefficients.
+     *
+     * For long kernels use Convolver instead.
+     */
+    class FilterSimd
+    {
+        static constexpr int outputsPerPass = 4;
+
+        std::vector<Simd::float8> coefficients;   // reversed, padded, L / 8 vectors
+        std::vector<float> buffer;                // 2L, every sample stored at pos and pos + L
+
+        int length = 0;             // padded length L
+        int numberOfTaps = 0;
+        int position = 0;
+
+        inline void push(float x)
+        {
+            buffer[position] = x;
+            buffer[position + length] = x;
+        }
+
+        inline void advance()
+        {
+            if (++position == length) position = 0;
+        }
+
+        inline float dot(const float* window) const
+        {
+            Simd::float8 acc = 0.0f;
+
+            const int vectors = length / 8;
+            for (int v = 0; v < vectors; v++)
+                acc = Simd::fma(coefficients[v], Simd::float8::loadUnaligned(window + v * 8), acc);
+
+            return acc.sum();
+        }
+
+    public:
+        /**
+         * @brief Coefficients already in the internal layout, reversed and zero-padded at the front, so setting them is a plain copy.
+         */
+        struct Kernel
+        {
+            std::vector<Simd::float8> vectors;
+            int numberOfTaps = 0;
+
+            Kernel() = default;
+
+            explicit Kernel(int taps) : vectors(getPaddedLength(taps) / 8, Simd::float8(0.0f)), numberOfTaps(taps) {}
+
+            /** @return The numberOfTaps slots after the padding, to be filled with the taps in reverse order */
+            float* getTaps() { return reinterpret_cast<float*>(vectors.data()) + vectors.size() * 8 - numberOfTaps; }
+            const float* getTaps() const { return reinterpret_cast<const float*>(vectors.data()) + vectors.size() * 8 - numberOfTaps; }
+        };
+
+        /**
+         * @return Padded length L for a number of taps: a multiple of 8 with at least 3 leading zeros
+         */
+        static int getPaddedLength(int taps) { return (taps + outputsPerPass - 1 + 7) / 8 * 8; }
+
+        template <typename T>
+        void setCoefficients(const std::vector<T>& newCoefficients)
+        {
+            Kernel kernel(static_cast<int>(newCoefficients.size()));
+
+            float* taps = kernel.getTaps();
+            for (int i = 0; i < kernel.numberOfTaps; i++) taps[kernel.numberOfTaps - 1 - i] = static_cast<float>(newCoefficients[i]);
+
+            setCoefficients(kernel);
+        }
+
+        void setCoefficients(const Kernel& kernel)
+        {
+            numberOfTaps = kernel.numberOfTaps;
+            length = static_cast<int>(kernel.vectors.size()) * 8;
+
+            coefficients = kernel.vectors;
+
+            buffer.resize(length * 2);
+            reset();
+        }
+
+        void reset()
+        {
+            std::fill(buffer.begin(), buffer.end(), 0.0f);
+            position = 0;
+        }
+
+        int getNumberOfTaps() const { return numberOfTaps; }
+
+        float process(float x)
+        {
+            push(x);
+            const float y = dot(buffer.data() + position + 1);
+            advance();
+            return y;
+        }
+
+        /**
+         * @brief Filter a block of samples, 4 outputs per pass over the coefficients.
+         *
+         * @param in Input samples
+         * @param out Output samples (may alias in)
+         * @param n Number of samples
+         */
+        void processBlock(const float* in, float* out, int n)
+        {
+            const int vectors = length / 8;
+            const float* data = buffer.data();
+
+            int i = 0;
+            for (; i + outputsPerPass <= n; i += outputsPerPass)
+            {
+                const float* window[outputsPerPass];
+
+                for (int k = 0; k < outputsPerPass; k++)
+                {
+                    push(in[i + k]);
+                    window[k] = data + position + 1;
+                    advance();
+                }
+
+                Simd::float8 acc0 = 0.0f, acc1 = 0.0f, acc2 = 0.0f, acc3 = 0.0f;
+
+                for (int v = 0; v < vectors; v++)
+                {
+                    const Simd::float8 c = coefficients[v];
+                    acc0 = Simd::fma(c, Simd::float8::loadUnaligned(window[0] + v * 8), acc0);
+                    acc1 = Simd::fma(c, Simd::float8::loadUnaligned(window[1] + v * 8), acc1);
+                    acc2 = Simd::fma(c, Simd::float8::loadUnaligned(window[2] + v * 8), acc2);
+                    acc3 = Simd::fma(c, Simd::float8::loadUnaligned(window[3] + v * 8), acc3);
+                }
+
+                out[i]     = acc0.sum();
+                out[i + 1] = acc1.sum();
+                out[i + 2] = acc2.sum();
+                out[i + 3] = acc3.sum();
+            }
+
+            for (; i < n; i++) out[i] = process(in[i]);
+        }
+
+        void processBlock(float* samples, int n) { processBlock(samples, samples, n); }
+    };
+
+    /**
+     * @brief WindowedSincLowpass() computed in float straight into the FilterSimd layout.
+     *
+     * The kernel is symmetric, so its reverse is the kernel itself and it is
+     * written in place after the padding.
+     */
+    static FilterSimd::Kernel WindowedSincLowpassKernel(double cutoff, double duration, double sr, Window window = Window::BlackmanNuttall)
+    {
+        const size_t N = WindowedSincLength(duration, sr);
+
+        FilterSimd::Kernel kernel(static_cast<int>(N));
+        WindowedSincLowpass(kernel.getTaps(), N, cutoff, sr, window);
+        return kernel;
+    }
+
+    /**
+     * @brief Shared store of windowed-sinc kernels, keyed by (cutoff, duration, sample rate, window).
+     *
+     * Instances with the same settings then share one kernel, computed on the
+     * first request, and a change of cutoff or sample rate to settings seen
+     * before costs a lookup. Kernels are computed outside the lock and handed
+     * out as shared pointers, which stay valid when the cache is cleared; it
+     * is cleared when it reaches its maximum size. Use it from setContext()
+     * and parameter changes, not per sample.
+     *
+     *     filter.setCoefficients(*WindowedSincCache::getShared().get(cutoff, duration, sr));
+     */
+    class WindowedSincCache
+    {
+        struct Key
+        {
+            double cutoff, duration, sr;
+            Window window;
+
+            bool operator==(const Key& other) const
+            {
+                return cutoff == other.cutoff && duration == other.duration && sr == other.sr && window == other.window;
+            }
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const
+            {
+                const double fields[] = { key.cutoff, key.duration, key.sr };
+
+                uint64_t h = static_cast<uint64_t>(key.window) + 0x9e3779b97f4a7c15ull;
+                for (double f : fields)
+                {
+                    uint64_t bits;
+                    std::memcpy(&bits, &f, sizeof(bits));
+                    h = (h ^ bits) * 0x100000001b3ull;
+                }
+                return static_cast<size_t>(h ^ (h >> 32));
+            }
+        };
+
+        std::unordered_map<Key, std::shared_ptr<const FilterSimd::Kernel>, KeyHash> entries;
+        mutable std::mutex mutex;
+        size_t maximumSize = 256;
+
+    public:
+        /**
+         * @brief Kernel of WindowedSincLowpassKernel() for these settings.
+         */
+        std::shared_ptr<const FilterSimd::Kernel> get(double cutoff, double duration, double sr, Window window = Window::BlackmanNuttall)
+        {
+            const Key key { cutoff, duration, sr, window };
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (const auto it = entries.find(key); it != entries.end()) return it->second;
+            }
+
+            auto kernel = std::make_shared<const FilterSimd::Kernel>(WindowedSincLowpassKernel(cutoff, duration, sr, window));
+
+            std::lock_guard<std::mutex> lock(mutex);
+
+            // Another thread may have computed the same kernel meanwhile; keep the first
+            if (const auto it = entries.find(key); it != entries.end()) return it->second;
+
+            if (entries.size() >= maximumSize) entries.clear();
+
+            entries.emplace(key, kernel);
+            return kernel;
+        }
+
+        void setMaximumSize(size_t numberOfEntries)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            maximumSize = numberOfEntries > 0 ? numberOfEntries : 1;
+        }
+
+        size_t size() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return entries.size();
+        }
+
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            entries.clear();
+        }
+
+        /**
+         * @brief Process-wide cache.
+         */
+        static WindowedSincCache& getShared()
+        {
+            static WindowedSincCache cache;
+            return cache;
+        }
+    };
+}
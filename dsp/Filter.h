@@ -1,10 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <type_traits>
 
 #include "Context.h"
+#include "Denormals.h"
 #include "../math/Complex.h"
 #include "../math/Math.h"
 
@@ -36,6 +38,23 @@ namespace Ath::Dsp::Filter
         return normFrequencyToG(freq * sampleT);
     }
 
+    /**
+     * @brief Convert a block of frequencies in Hz to filter coefficients g.
+     *
+     * No dependency between samples, so the loop vectorizes; with SIMD T
+     * each lane is one voice.
+     *
+     * @param freq Frequencies in Hz
+     * @param g Output coefficients
+     * @param n Number of values
+     * @param sampleT Sample period (1/sampleRate)
+     */
+    template <typename T>
+    static inline void frequencyToG(const T* freq, T* g, int n, T sampleT)
+    {
+        for (int i = 0; i < n; i++) g[i] = frequencyToG(freq[i], sampleT);
+    }
+
     /**
      * @brief Convert smoothing time to filter coefficient g.
      *
@@ -96,6 +115,12 @@ namespace Ath::Dsp::Filter
         return s / (wc + s);
     }
 
+    namespace Biquad
+    {
+        template <typename T>
+        struct DigitalBiquadCoefficients;
+    }
+
     // ============================================================
     // Naive one-pole filters
     // ============================================================
@@ -149,6 +174,35 @@ namespace Ath::Dsp::Filter
                 return y;
             }
 
+            /**
+             * @brief Process a block of samples.
+             *
+             * Filter state is kept in locals for the duration of the loop,
+             * no virtual dispatch happens per sample.
+             *
+             * @param in Input samples
+             * @param out Output samples (may alias in)
+             * @param n Number of samples
+             */
+            void processBlock(const T* in, T* out, int n)
+            {
+                if (Dsp::isSilent(in, n, { y }))
+                {
+                    y = T(0.0);
+                    std::fill_n(out, n, T(0.0));
+                    return;
+                }
+
+                T state = y;
+                const T coeff = g;
+
+                for (int i = 0; i < n; i++) out[i] = processLP(in[i], state, coeff);
+
+                y = state;
+            }
+
+            void processBlock(T* buffer, int n) { processBlock(buffer, buffer, n); }
+
             inline T last() { return y; }
         };
     }
@@ -158,6 +212,12 @@ namespace Ath::Dsp::Filter
     // ============================================================
     namespace TPT 
     {
+        /**
+         * Modulated block processing converts this many cutoff values at a
+         * time into coefficients, in a separate loop from the filter recursion.
+         */
+        static constexpr int modulationChunkSize = 32;
+
         template <typename T>
         static inline T processLP(T x, T& z1, T G)
         {
@@ -195,6 +255,17 @@ namespace Ath::Dsp::Filter
 
             T frequency = 100.f;
 
+            // Quiescence detection: silent state and input give a silent block without running the recursion
+            bool sleep(const T* in, T* out, int n)
+            {
+                if (!Dsp::isSilent(in, n, { z1 })) return false;
+
+                z1 = T(0.0);
+                y = T(0.0);
+                std::fill_n(out, n, T(0.0));
+                return true;
+            }
+
         public:
             void reset() { z1 = 0; }
 
@@ -217,12 +288,95 @@ namespace Ath::Dsp::Filter
                 return transferLP1(wc, s);
             }
 
+            /**
+             * @brief The filter as a normalised first-order biquad (b2 = a2 = 0), e.g. for FrequencyResponse.
+             */
+            Biquad::DigitalBiquadCoefficients<T> getCoefficients() const
+            {
+                // Trapezoidal integrator with gain g = G / (1 - G): H(z) = G (1 + z^-1) / (1 + (2G - 1) z^-1)
+                Biquad::DigitalBiquadCoefficients<T> coeffs;
+                coeffs.b0 = G;
+                coeffs.b1 = G;
+                coeffs.b2 = T(0.0);
+                coeffs.a1 = T(2.0) * G - T(1.0);
+                coeffs.a2 = T(0.0);
+                return coeffs;
+            }
+
             virtual inline T process(T x)
             {
                 y = processLP(x, z1, G);
                 return y;
             }
 
+            /**
+             * @brief Process a block of samples without per-sample virtual dispatch.
+             *
+             * Blocks with silent input and state (Dsp::isSilent) skip the
+             * recursion and output zeros; the same holds for every block method
+             * of the TPT filters.
+             *
+             * @param in Input samples
+             * @param out Output samples (may alias in)
+             * @param n Number of samples
+             */
+            void processBlock(const T* in, T* out, int n)
+            {
+                if (n <= 0) return;
+                if (sleep(in, out, n)) return;
+
+                T state = z1;
+                const T coeff = G;
+
+                for (int i = 0; i < n; i++) out[i] = processLP(in[i], state, coeff);
+
+                z1 = state;
+                y = out[n - 1];
+            }
+
+            void processBlock(T* buffer, int n) { processBlock(buffer, buffer, n); }
+
+            /**
+             * @brief Process a block with a per-sample cutoff, e.g. audio-rate modulation.
+             *
+             * Coefficients are computed in chunks ahead of the recursion, so that
+             * part vectorizes. The filter keeps the last cutoff afterwards.
+             *
+             * @param in Input samples
+             * @param cutoff Cutoff frequency in Hz for every sample
+             * @param out Output samples (may alias in)
+             * @param n Number of samples
+             */
+            void processBlockModulated(const T* in, const T* cutoff, T* out, int n)
+            {
+                if (n <= 0) return;
+
+                if (sleep(in, out, n))
+                {
+                    setCutoffFrequency(cutoff[n - 1]);
+                    return;
+                }
+
+                T coeffs[modulationChunkSize];
+                T state = z1;
+
+                for (int start = 0; start < n; start += modulationChunkSize)
+                {
+                    const int m = std::min(modulationChunkSize, n - start);
+                    frequencyToG(cutoff + start, coeffs, m, T(c.T));
+
+                    for (int i = 0; i < m; i++) out[start + i] = processLP(in[start + i], state, coeffs[i]);
+
+                    G = coeffs[m - 1];
+                }
+
+                z1 = state;
+                y = out[n - 1];
+                frequency = cutoff[n - 1];
+            }
+
+            void processBlockModulated(T* buffer, const T* cutoff, int n) { processBlockModulated(buffer, cutoff, buffer, n); }
+
             inline T last() { return y; }
         };
 
@@ -239,6 +393,17 @@ namespace Ath::Dsp::Filter
 
             T frequency;
 
+            // Quiescence detection: silent state and input give a silent block without running the recursion
+            bool sleep(const T* in, T* out, int n)
+            {
+                if (!Dsp::isSilent(in, n, { z1 })) return false;
+
+                z1 = T(0.0);
+                y = T(0.0);
+                std::fill_n(out, n, T(0.0));
+                return true;
+            }
+
         public:
             void reset() { z1 = 0; }
 
@@ -261,11 +426,92 @@ namespace Ath::Dsp::Filter
                 return transferHP1(wc, s);
             }
 
+            /**
+             * @brief The filter as a normalised first-order biquad (b2 = a2 = 0), e.g. for FrequencyResponse.
+             */
+            Biquad::DigitalBiquadCoefficients<T> getCoefficients() const
+            {
+                // 1 - low-pass: H(z) = (1 - G) (1 - z^-1) / (1 + (2G - 1) z^-1)
+                Biquad::DigitalBiquadCoefficients<T> coeffs;
+                coeffs.b0 = T(1.0) - G;
+                coeffs.b1 = G - T(1.0);
+                coeffs.b2 = T(0.0);
+                coeffs.a1 = T(2.0) * G - T(1.0);
+                coeffs.a2 = T(0.0);
+                return coeffs;
+            }
+
             inline T process(T x)
             {
                 y = processHP(x, z1, G);
                 return y;
             }
+
+            /**
+             * @brief Process a block of samples.
+             *
+             * @param in Input samples
+             * @param out Output samples (may alias in)
+             * @param n Number of samples
+             */
+            void processBlock(const T* in, T* out, int n)
+            {
+                if (n <= 0) return;
+                if (sleep(in, out, n)) return;
+
+                T state = z1;
+                const T coeff = G;
+
+                for (int i = 0; i < n; i++) out[i] = processHP(in[i], state, coeff);
+
+                z1 = state;
+                y = out[n - 1];
+            }
+
+            void processBlock(T* buffer, int n) { processBlock(buffer, buffer, n); }
+
+            /**
+             * @brief Process a block with a per-sample cutoff, e.g. audio-rate modulation.
+             *
+             * Coefficients are computed in chunks ahead of the recursion, so that
+             * part vectorizes. The filter keeps the last cutoff afterwards.
+             *
+             * @param in Input samples
+             * @param cutoff Cutoff frequency in Hz for every sample
+             * @param out Output samples (may alias in)
+             * @param n Number of samples
+             */
+            void processBlockModulated(const T* in, const T* cutoff, T* out, int n)
+            {
+                if (n <= 0) return;
+
+                if (sleep(in, out, n))
+                {
+                    setCutoffFrequency(cutoff[n - 1]);
+                    return;
+                }
+
+                T coeffs[modulationChunkSize];
+                T state = z1;
+
+                for (int start = 0; start < n; start += modulationChunkSize)
+                {
+                    const int m = std::min(modulationChunkSize, n - start);
+                    frequencyToG(cutoff + start, coeffs, m, T(c.T));
+
+                    for (int i = 0; i < m; i++) out[start + i] = processHP(in[start + i], state, coeffs[i]);
+
+                    G = coeffs[m - 1];
+                }
+
+                z1 = state;
+                y = out[n - 1];
+                frequency = cutoff[n - 1];
+            }
+
+            void processBlockModulated(T* buffer, const T* cutoff, int n) { processBlockModulated(buffer, cutoff, buffer, n); }
+
+            inline T last() { return y; }
         };
 
         /**
@@ -304,6 +550,130 @@ namespace Ath::Dsp::Filter
                 d  = T(1.0) / (T(1.0) + g1 * G);
             }
 
+            Biquad::DigitalBiquadCoefficients<T> coefficientsFor(T b0, T b1, T b2) const
+            {
+                const T a0 = T(1.0) + T(2.0) * R * G + G * G;
+
+                Biquad::DigitalBiquadCoefficients<T> coeffs;
+                coeffs.b0 = b0 / a0;
+                coeffs.b1 = b1 / a0;
+                coeffs.b2 = b2 / a0;
+                coeffs.a1 = T(2.0) * (G * G - T(1.0)) / a0;
+                coeffs.a2 = (T(1.0) - T(2.0) * R * G + G * G) / a0;
+                return coeffs;
+            }
+
+            enum class Output { HighPass, BandPass, LowPass };
+
+            // Quiescence detection, see TPT::LowPass1
+            bool sleep(const T* in, T* out, int n)
+            {
+                if (!Dsp::isSilent(in, n, { s1, s2 })) return false;
+
+                s1 = s2 = T(0.0);
+                hp = bp = lp = T(0.0);
+                std::fill_n(out, n, T(0.0));
+                return true;
+            }
+
+            template <Output output>
+            void processBlockInternal(const T* in, T* out, int n)
+            {
+                if (n <= 0) return;
+                if (sleep(in, out, n)) return;
+
+                const T cG  = G;
+                const T cg1 = g1;
+                const T cd  = d;
+
+                T z1 = s1;
+                T z2 = s2;
+
+                T yhp = hp, ybp = bp, ylp = lp;
+
+                for (int i = 0; i < n; i++)
+                {
+                    yhp = (in[i] - cg1 * z1 - z2) * cd;
+
+                    const T v1 = cG * yhp;
+                    ybp = v1 + z1;
+                    z1  = ybp + v1;
+
+                    const T v2 = cG * ybp;
+                    ylp = v2 + z2;
+                    z2  = ylp + v2;
+
+                    if constexpr (output == Output::HighPass) out[i] = yhp;
+                    if constexpr (output == Output::BandPass) out[i] = ybp;
+                    if constexpr (output == Output::LowPass)  out[i] = ylp;
+                }
+
+                s1 = z1; s2 = z2;
+                hp = yhp; bp = ybp; lp = ylp;
+            }
+
+            template <Output output>
+            void processBlockModulatedInternal(const T* in, const T* cutoff, T* out, int n)
+            {
+                if (n <= 0) return;
+
+                if (sleep(in, out, n))
+                {
+                    setCutoffFrequency(cutoff[n - 1]);
+                    return;
+                }
+
+                T coeffG[modulationChunkSize];
+                T coeffg1[modulationChunkSize];
+                T coeffd[modulationChunkSize];
+
+                const T cR = R;
+
+                T z1 = s1;
+                T z2 = s2;
+
+                T yhp = hp, ybp = bp, ylp = lp;
+
+                for (int start = 0; start < n; start += modulationChunkSize)
+                {
+                    const int m = std::min(modulationChunkSize, n - start);
+
+                    // Coefficients first, including the division, without the recursion in the way
+                    frequencyToG(cutoff + start, coeffG, m, T(c.T));
+                    for (int i = 0; i < m; i++)
+                    {
+                        coeffg1[i] = T(2.0) * cR + coeffG[i];
+                        coeffd[i] = T(1.0) / (T(1.0) + coeffg1[i] * coeffG[i]);
+                    }
+
+                    const T* x = in + start;
+                    for (int i = 0; i < m; i++)
+                    {
+                        yhp = (x[i] - coeffg1[i] * z1 - z2) * coeffd[i];
+
+                        const T v1 = coeffG[i] * yhp;
+                        ybp = v1 + z1;
+                        z1  = ybp + v1;
+
+                        const T v2 = coeffG[i] * ybp;
+                        ylp = v2 + z2;
+                        z2  = ylp + v2;
+
+                        if constexpr (output == Output::HighPass) out[start + i] = yhp;
+                        if constexpr (output == Output::BandPass) out[start + i] = ybp;
+                        if constexpr (output == Output::LowPass)  out[start + i] = ylp;
+                    }
+
+                    G = coeffG[m - 1];
+                    g1 = coeffg1[m - 1];
+                    d = coeffd[m - 1];
+                }
+
+                s1 = z1; s2 = z2;
+                hp = yhp; bp = ybp; lp = ylp;
+                frequency = cutoff[n - 1];
+            }
+
             inline void processInternal(T x)
             {
                 // High-pass
@@ -341,14 +711,49 @@ namespace Ath::Dsp::Filter
             {
                 resonance = Math::clamp(r, T(0.0), T(1.0));
                 static const T max_resonance = T(0.1);
-                R = Math::lerp(1.0, max_resonance, resonance);
+                R = Math::lerp(T(1.0), max_resonance, resonance);
                 updateCoefficients();
             }
 
+            /**
+             * @brief The outputs as normalised biquads, e.g. for FrequencyResponse.
+             *
+             * With the trapezoidal integrator G (1 + z^-1) / (1 - z^-1), all three
+             * share the denominator (1 + 2RG + G^2) + 2(G^2 - 1) z^-1 + (1 - 2RG + G^2) z^-2.
+             */
+            Biquad::DigitalBiquadCoefficients<T> getHighPassCoefficients() const { return coefficientsFor(T(1.0), T(-2.0), T(1.0)); }
+            Biquad::DigitalBiquadCoefficients<T> getBandPassCoefficients() const { return coefficientsFor(G, T(0.0), -G); }
+            Biquad::DigitalBiquadCoefficients<T> getLowPassCoefficients() const  { return coefficientsFor(G * G, T(2.0) * G * G, G * G); }
+
             T processHighPass(T x) { processInternal(x); return hp; }
             T processBandPass(T x) { processInternal(x); return bp; }
             T processLowPass(T x)  { processInternal(x); return lp; }
 
+            /**
+             * @brief Block variants of the per-sample outputs.
+             *
+             * All three outputs stay available through last*() after the call.
+             * Output buffers may alias the input.
+             */
+            void processBlockHighPass(const T* in, T* out, int n) { processBlockInternal<Output::HighPass>(in, out, n); }
+            void processBlockBandPass(const T* in, T* out, int n) { processBlockInternal<Output::BandPass>(in, out, n); }
+            void processBlockLowPass(const T* in, T* out, int n)  { processBlockInternal<Output::LowPass>(in, out, n); }
+
+            void processBlockHighPass(T* buffer, int n) { processBlockHighPass(buffer, buffer, n); }
+            void processBlockBandPass(T* buffer, int n) { processBlockBandPass(buffer, buffer, n); }
+            void processBlockLowPass(T* buffer, int n)  { processBlockLowPass(buffer, buffer, n); }
+
+            /**
+             * @brief Block variants with a per-sample cutoff in Hz, e.g. audio-rate modulation.
+             *
+             * Coefficients are computed in chunks ahead of the recursion, so that
+             * part vectorizes; with SIMD T each lane can be a voice. The filter
+             * keeps the last cutoff afterwards. Output buffers may alias the input.
+             */
+            void processBlockHighPassModulated(const T* in, const T* cutoff, T* out, int n) { processBlockModulatedInternal<Output::HighPass>(in, cutoff, out, n); }
+            void processBlockBandPassModulated(const T* in, const T* cutoff, T* out, int n) { processBlockModulatedInternal<Output::BandPass>(in, cutoff, out, n); }
+            void processBlockLowPassModulated(const T* in, const T* cutoff, T* out, int n)  { processBlockModulatedInternal<Output::LowPass>(in, cutoff, out, n); }
+
             inline T lastHighPass() const { return hp; }
             inline T lastBandPass() const { return bp; }
             inline T lastLowPass()  const { return lp; }
@@ -396,7 +801,7 @@ namespace Ath::Dsp::Filter
          * @brief Compute digital biquad transfer function at a given frequency
          */
         template <typename T>
-        static Math::complex<T> transfer(DigitalBiquadCoefficients<T> coeffs, Math::complex<T> s, T sr)
+        static constexpr Math::complex<T> transfer(DigitalBiquadCoefficients<T> coeffs, Math::complex<T> s, T sr)
         {
             auto k = sr * 2.0f;
             auto z1 = (k - s) / (k + s);
@@ -406,9 +811,12 @@ namespace Ath::Dsp::Filter
 
         /**
          * @brief Convert analog biquad coefficients to digital using bilinear transform
+         *
+         * constexpr, so fixed stages can be designed at compile time. Pair with
+         * prewarp() (BiquadDesign.h) to place a frequency exactly.
          */
         template <typename T>
-        static DigitalBiquadCoefficients<T> bilinear(AnalogBiquadCoefficients<T> in, double sr)
+        static constexpr DigitalBiquadCoefficients<T> bilinear(AnalogBiquadCoefficients<T> in, double sr)
         {
             const auto k = sr * 2.0;
             const auto k2 = k * k;
@@ -446,6 +854,14 @@ namespace Ath::Dsp::Filter
             using DF2state = std::conditional_t<isDF2orTDF2, T, Empty>;
             DF2state v1, v2;
 
+            // Quiescence detection: silent state and input give a silent block without running the recursion
+            bool isSilent(const T* in, int n) const
+            {
+                if constexpr(isDF1) return Dsp::isSilent(in, n, { x1, x2, y1, y2 });
+                if constexpr(isTDF1) return Dsp::isSilent(in, n, { s0, s1, s2, s3 });
+                if constexpr(isDF2orTDF2) return Dsp::isSilent(in, n, { v1, v2 });
+            }
+
         public:
             DigitalBiquadCoefficients<T> coeffs;
 
@@ -486,6 +902,96 @@ namespace Ath::Dsp::Filter
                 }
             }
 
+            /**
+             * @brief Process a block of samples.
+             *
+             * Coefficients and state are copied to locals for the duration of the loop.
+             * A block with silent input and state (Dsp::isSilent) resets the state
+             * and outputs zeros instead.
+             *
+             * @param in Input samples
+             * @param out Output samples (may alias in)
+             * @param n Number of samples
+             */
+            void processBlock(const T* in, T* out, int n)
+            {
+                if (n <= 0) return;
+
+                if (isSilent(in, n))
+                {
+                    reset();
+                    std::fill_n(out, n, T(0.0));
+                    return;
+                }
+
+                const T b0 = coeffs.b0, b1 = coeffs.b1, b2 = coeffs.b2;
+                const T a1 = coeffs.a1, a2 = coeffs.a2;
+
+                if constexpr(Topology == BiquadTopology::DirectForm1)
+                {
+                    T lx1 = x1, lx2 = x2, ly1 = y1, ly2 = y2;
+
+                    for (int i = 0; i < n; i++)
+                    {
+                        const T x = in[i];
+                        const T ly = b0 * x + b1 * lx1 + b2 * lx2 - a1 * ly1 - a2 * ly2;
+                        lx2 = lx1; lx1 = x; ly2 = ly1; ly1 = ly;
+                        out[i] = ly;
+                    }
+
+                    x1 = lx1; x2 = lx2; y1 = ly1; y2 = ly2;
+                }
+                if constexpr(Topology == BiquadTopology::DirectForm2)
+                {
+                    T lv1 = v1, lv2 = v2;
+
+                    for (int i = 0; i < n; i++)
+                    {
+                        const T w = in[i] - a1 * lv1 - a2 * lv2;
+                        out[i] = b0 * w + b1 * lv1 + b2 * lv2;
+                        lv2 = lv1; lv1 = w;
+                    }
+
+                    v1 = lv1; v2 = lv2;
+                }
+                if constexpr(Topology == BiquadTopology::TransposedDirectForm1)
+                {
+                    T ls0 = s0, ls1 = s1, ls2 = s2, ls3 = s3;
+
+                    for (int i = 0; i < n; i++)
+                    {
+                        const T x = in[i];
+                        const T ly = ls0 + ls2 + b0 * x;
+                        ls0 = ls1 + b1 * x;
+                        ls1 = b2 * x;
+                        ls2 = ls3 - a1 * ly;
+                        ls3 = -a2 * ly;
+                        out[i] = ly;
+                    }
+
+                    s0 = ls0; s1 = ls1; s2 = ls2; s3 = ls3;
+                }
+                if constexpr(Topology == BiquadTopology::TransposedDirectForm2)
+                {
+                    T lv1 = v1, lv2 = v2;
+
+                    for (int i = 0; i < n; i++)
+                    {
+                        const T x = in[i];
+                        const T ly = b0 * x + lv1;
+                        lv1 = b1 * x - a1 * ly + lv2;
+                        lv2 = b2 * x - a2 * ly;
+                        out[i] = ly;
+                    }
+
+                    v1 = lv1; v2 = lv2;
+                }
+
+                y = out[n - 1];
+            }
+
+            void processBlock(T* buffer, int n) { processBlock(buffer, buffer, n); }
+
             inline T last() { return y; }
 
             void reset()
@@ -515,6 +1021,31 @@ namespace Ath::Dsp::Filter
                 return y;
             }
 
+            /**
+             * @brief Process a block of samples stage by stage.
+             *
+             * Each biquad runs over the whole block before the next one,
+             * so every stage keeps its state in registers for the full loop.
+             */
+            void processBlock(const T* in, T* out, int n)
+            {
+                if (n <= 0) return;
+
+                if constexpr (N == 0)
+                {
+                    if (in != out) std::copy(in, in + n, out);
+                }
+                else
+                {
+                    biquads[0].processBlock(in, out, n);
+                    for (int i = 1; i < N; i++) biquads[i].processBlock(out, out, n);
+                }
+
+                y = out[n - 1];
+            }
+
+            void processBlock(T* buffer, int n) { processBlock(buffer, buffer, n); }
+
             T last() { return y; }
         };
     } // namespace Biquad
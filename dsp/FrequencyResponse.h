@@ -0,0 +1,280 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <span>
+#include <vector>
+
+#include "Filter.h"
+#include "../math/Complex.h"
+#include "../math/Math.h"
+#include "../math/Simd.h"
+
+namespace Ath::Dsp::Filter
+{
+    /**
+     * @brief Batched frequency response of a chain of filters, for drawing EQ curves off the audio thread.
+     *
+     * The chain is a list of bands; each band is a cascade of biquad sections
+     * (Biquad, BiquadCascade, or the getCoefficients() of the TPT filters) or
+     * an FIR kernel. Responses are evaluated on the unit circle for a fixed
+     * grid of frequencies, SIMD-wide, in Math::ComplexBuffer (SoA) arrays.
+     *
+     * Each band keeps its own response, and update() only recomputes bands
+     * whose coefficients changed since the last call, then the chain total if
+     * any did. Setting a band to the coefficients it already has is free.
+     */
+    class FrequencyResponse
+    {
+        using V = Math::ComplexBuffer::Vector;
+        using Complex = Math::complexN<V>;
+        using Coefficients = Biquad::DigitalBiquadCoefficients<float>;
+
+        static constexpr int lanes = Math::ComplexBuffer::vectorSize;
+
+        struct Band
+        {
+            std::vector<Coefficients> sections;
+            std::vector<float> fir;
+            bool isFir = false;
+            bool dirty = true;
+
+            Math::ComplexBuffer response;
+        };
+
+        std::vector<float> frequencies;
+        float sampleRate = 48000.0f;
+
+        // z^-1 and z^-2 on the unit circle, per frequency
+        Math::ComplexBuffer z1, z2;
+
+        std::vector<Band> bands;
+        Math::ComplexBuffer total;
+        bool totalValid = false;
+
+        std::vector<float> magnitude;
+        std::vector<float> phase;
+        std::vector<float> bandMagnitude;
+
+        int getNumberOfVectors() const { return z1.getNumberOfVectors(); }
+
+        static bool equal(const Coefficients& a, const Coefficients& b)
+        {
+            return a.b0 == b.b0 && a.b1 == b.b1 && a.b2 == b.b2 && a.a1 == b.a1 && a.a2 == b.a2;
+        }
+
+        void evaluate(Band& band)
+        {
+            const int numberOfVectors = getNumberOfVectors();
+            Math::ComplexBuffer& response = band.response;
+
+            response.resize(z1.getSize());
+            for (int v = 0; v < numberOfVectors; v++) response.setVector(v, Complex(V(1.0f), V(0.0f)));
+
+            if (band.isFir)
+            {
+                if (band.fir.empty()) return;
+
+                // Horner in z^-1: h0 + z^-1 (h1 + z^-1 (h2 + ...))
+                for (int v = 0; v < numberOfVectors; v++)
+                {
+                    const Complex z = z1.getVector(v);
+
+                    Complex h(V(band.fir.back()), V(0.0f));
+                    for (int k = static_cast<int>(band.fir.size()) - 2; k >= 0; k--) h = h * z + V(band.fir[k]);
+
+                    response.setVector(v, h);
+                }
+                return;
+            }
+
+            for (const auto& c : band.sections)
+            {
+                const V b0(c.b0), b1(c.b1), b2(c.b2), a1(c.a1), a2(c.a2);
+
+                for (int v = 0; v < numberOfVectors; v++)
+                {
+                    const Complex zz1 = z1.getVector(v);
+                    const Complex zz2 = z2.getVector(v);
+
+                    const Complex numerator = zz1 * b1 + zz2 * b2 + b0;
+                    const Complex denominator = zz1 * a1 + zz2 * a2 + V(1.0f);
+
+                    response.setVector(v, response.getVector(v) * (numerator / denominator));
+                }
+            }
+        }
+
+        void toDecibels(const Math::ComplexBuffer& response, std::vector<float>& out) const
+        {
+            const int n = static_cast<int>(frequencies.size());
+            out.resize(static_cast<size_t>(getNumberOfVectors()) * lanes);
+
+            // 10 log10(|H|^2), floored at -240 dB so zeros stay finite
+            for (int v = 0; v < getNumberOfVectors(); v++)
+            {
+                const V power = Simd::max(Math::norm(response.getVector(v)), V(1.0e-24f));
+                (V(3.0102999566f) * Simd::fastLog2(power)).storeUnaligned(out.data() + v * lanes);
+            }
+
+            out.resize(n);
+        }
+
+    public:
+        /**
+         * @brief Fill out with log-spaced frequencies from lowest to highest, both included.
+         */
+        static void logFrequencyGrid(std::span<float> out, float lowest, float highest)
+        {
+            const int n = static_cast<int>(out.size());
+            if (n == 0) return;
+            if (n == 1) { out[0] = lowest; return; }
+
+            const double ratio = std::log(double(highest) / double(lowest)) / double(n - 1);
+            for (int i = 0; i < n; i++) out[i] = static_cast<float>(double(lowest) * std::exp(ratio * i));
+        }
+
+        /**
+         * @brief Set the frequency grid. Marks every band for recomputation.
+         *
+         * @param hz Frequencies in Hz, below sampleRate / 2
+         */
+        void setFrequencies(std::span<const float> hz, float newSampleRate)
+        {
+            frequencies.assign(hz.begin(), hz.end());
+            sampleRate = newSampleRate;
+
+            const int n = static_cast<int>(frequencies.size());
+            z1.resize(n);
+            z2.resize(n);
+
+            for (int i = 0; i < n; i++)
+            {
+                const double w = 2.0 * std::numbers::pi * double(frequencies[i]) / double(sampleRate);
+
+                // z^-k = cos(kw) - j sin(kw)
+                z1.real()[i] = static_cast<float>(std::cos(w));
+                z1.imag()[i] = static_cast<float>(-std::sin(w));
+                z2.real()[i] = static_cast<float>(std::cos(2.0 * w));
+                z2.imag()[i] = static_cast<float>(-std::sin(2.0 * w));
+            }
+
+            totalValid = false;
+            for (auto& band : bands) band.dirty = true;
+        }
+
+        std::span<const float> getFrequencies() const { return frequencies; }
+
+        /**
+         * @return Index of a new band, initially flat
+         */
+        int addBand()
+        {
+            bands.emplace_back();
+            return static_cast<int>(bands.size()) - 1;
+        }
+
+        int getNumberOfBands() const { return static_cast<int>(bands.size()); }
+
+        /**
+         * @brief Set a band to a cascade of biquad sections (normalised, a0 = 1).
+         */
+        void setSections(int band, std::span<const Coefficients> sections)
+        {
+            Band& b = bands[band];
+
+            const bool same = !b.isFir && b.sections.size() == sections.size()
+                && std::equal(sections.begin(), sections.end(), b.sections.begin(), equal);
+            if (same) return;
+
+            b.isFir = false;
+            b.fir.clear();
+            b.sections.assign(sections.begin(), sections.end());
+            b.dirty = true;
+        }
+
+        void setBiquad(int band, const Coefficients& coeffs)
+        {
+            setSections(band, std::span<const Coefficients>(&coeffs, 1));
+        }
+
+        template <int N, Biquad::BiquadTopology Topology>
+        void setCascade(int band, const Biquad::BiquadCascade<float, N, Topology>& cascade)
+        {
+            std::array<Coefficients, N> sections;
+            for (int i = 0; i < N; i++) sections[i] = cascade.biquads[i].coeffs;
+            setSections(band, sections);
+        }
+
+        /**
+         * @brief Set a band to an FIR kernel, h[0] first.
+         */
+        void setFir(int band, std::span<const float> taps)
+        {
+            Band& b = bands[band];
+
+            const bool same = b.isFir && b.fir.size() == taps.size() && std::equal(taps.begin(), taps.end(), b.fir.begin());
+            if (same) return;
+
+            b.isFir = true;
+            b.sections.clear();
+            b.fir.assign(taps.begin(), taps.end());
+            b.dirty = true;
+        }
+
+        /**
+         * @brief Recompute the bands that changed and, if any did, the chain.
+         *
+         * @return Whether anything was recomputed
+         */
+        bool update()
+        {
+            bool changed = !totalValid;
+
+            for (auto& band : bands)
+            {
+                if (!band.dirty) continue;
+
+                evaluate(band);
+                band.dirty = false;
+                changed = true;
+            }
+
+            if (!changed) return false;
+
+            total.resize(z1.getSize());
+            for (int v = 0; v < getNumberOfVectors(); v++) total.setVector(v, Complex(V(1.0f), V(0.0f)));
+
+            for (const auto& band : bands) total.multiply(band.response);
+            totalValid = true;
+
+            toDecibels(total, magnitude);
+
+            phase.resize(frequencies.size());
+            total.phase(phase.data());
+
+            return true;
+        }
+
+        /**
+         * @brief Magnitude of the chain in dB, one value per frequency, as of the last update().
+         */
+        std::span<const float> getMagnitudeDecibels() const { return magnitude; }
+
+        /**
+         * @brief Phase of the chain in radians, wrapped to [-pi, pi] (to ~2e-6), as of the last update().
+         */
+        std::span<const float> getPhase() const { return phase; }
+
+        /**
+         * @brief Magnitude of one band in dB, as of the last update(). Valid until the next call.
+         */
+        std::span<const float> getBandMagnitudeDecibels(int band)
+        {
+            toDecibels(bands[band].response, bandMagnitude);
+            return bandMagnitude;
+        }
+    };
+}
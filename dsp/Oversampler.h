@@ -0,0 +1,384 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+#include "Context.h"
+#include "FIR.h"
+#include "FIRSimd.h"
+
+namespace Ath::Dsp::Filter::Fir
+{
+    /**
+     * @brief One polyphase component of a resampling filter.
+     *
+     * Runs as a SIMD direct-form FIR, or as a scaled delay line when the
+     * component has a single non-zero tap (as one phase of a half-band filter does).
+     */
+    class PolyphaseBranch
+    {
+        FilterSimd filter;
+
+        bool isDelay = false;
+        float gain = 0.0f;
+        int delay = 0;
+
+        std::vector<float> delayLine;
+        int position = 0;
+
+    public:
+        void setCoefficients(const std::vector<float>& taps)
+        {
+            const float peak = taps.empty() ? 0.0f : std::abs(*std::max_element(taps.begin(), taps.end(),
+                [](float a, float b) { return std::abs(a) < std::abs(b); }));
+
+            int nonZero = 0;
+            int last = 0;
+            for (int i = 0; i < static_cast<int>(taps.size()); i++)
+            {
+                if (std::abs(taps[i]) > peak * 1.0e-6f)
+                {
+                    nonZero++;
+                    last = i;
+                }
+            }
+
+            isDelay = nonZero == 1;
+
+            if (isDelay)
+            {
+                gain = taps[last];
+                delay = last;
+                delayLine.assign(delay + 1, 0.0f);
+            }
+            else
+            {
+                filter.setCoefficients(std::vector<float>(taps.begin(), taps.begin() + last + 1));
+            }
+
+            reset();
+        }
+
+        void reset()
+        {
+            filter.reset();
+            std::fill(delayLine.begin(), delayLine.end(), 0.0f);
+            position = 0;
+        }
+
+        void processBlock(const float* in, float* out, int n)
+        {
+            if (!isDelay)
+            {
+                filter.processBlock(in, out, n);
+                return;
+            }
+
+            const int size = delay + 1;
+            for (int i = 0; i < n; i++)
+            {
+                delayLine[position] = in[i];
+
+                int read = position - delay;
+                if (read < 0) read += size;
+
+                out[i] = delayLine[read] * gain;
+
+                if (++position == size) position = 0;
+            }
+        }
+    };
+
+    /**
+     * @brief Half-band kernel with a given number of taps, based on WindowedSincLowpass().
+     *
+     * @param numberOfTaps Requested length; the result has an odd number of taps
+     */
+    static std::vector<double> HalfbandKernel(int numberOfTaps)
+    {
+        // Normalized rate of 1 Hz: cutoff at a quarter of the (upsampled) rate, N = numberOfTaps
+        return WindowedSincLowpass(0.25, double(numberOfTaps | 1) + 0.5, 1.0);
+    }
+
+    /**
+     * @brief Polyphase 2x upsampler.
+     *
+     * Equivalent to zero stuffing followed by the half-band kernel, but each
+     * output phase is computed from its own precomputed sub-kernel at the low rate.
+     */
+    class HalfbandUpsampler
+    {
+        PolyphaseBranch even;
+        PolyphaseBranch odd;
+
+        std::vector<float> scratch;
+
+        int kernelLength = 0;
+
+    public:
+        /**
+         * @brief Set the kernel and the maximum number of input samples per call.
+         */
+        void setup(const std::vector<double>& kernel, int maxSamplesPerBlock)
+        {
+            kernelLength = static_cast<int>(kernel.size());
+
+            std::vector<float> phase0, phase1;
+            for (int i = 0; i < kernelLength; i++)
+            {
+                // Gain of 2 compensates for the energy removed by zero stuffing
+                const float tap = static_cast<float>(kernel[i] * 2.0);
+                (i % 2 == 0 ? phase0 : phase1).push_back(tap);
+            }
+
+            even.setCoefficients(phase0);
+            odd.setCoefficients(phase1);
+
+            scratch.resize(maxSamplesPerBlock * 2);
+        }
+
+        void reset()
+        {
+            even.reset();
+            odd.reset();
+        }
+
+        /** @return Group delay in output (high-rate) samples */
+        double getLatency() const { return (kernelLength - 1) * 0.5; }
+
+        /**
+         * @param in n input samples
+         * @param out 2n output samples
+         * @param n Number of input samples, at most maxSamplesPerBlock
+         */
+        void processBlock(const float* in, float* out, int n)
+        {
+            float* y0 = scratch.data();
+            float* y1 = scratch.data() + n;
+
+            even.processBlock(in, y0, n);
+            odd.processBlock(in, y1, n);
+
+            for (int m = 0; m < n; m++)
+            {
+                out[2 * m] = y0[m];
+                out[2 * m + 1] = y1[m];
+            }
+        }
+    };
+
+    /**
+     * @brief Polyphase 2x downsampler.
+     *
+     * Equivalent to filtering with the half-band kernel and dropping every odd
+     * sample, but only the kept outputs are computed, with one sub-kernel per input phase.
+     */
+    class HalfbandDownsampler
+    {
+        PolyphaseBranch even;
+        PolyphaseBranch odd;
+
+        std::vector<float> scratch;
+
+        float lastOdd = 0.0f;
+        int kernelLength = 0;
+
+    public:
+        /**
+         * @brief Set the kernel and the maximum number of output samples per call.
+         */
+        void setup(const std::vector<double>& kernel, int maxSamplesPerBlock)
+        {
+            kernelLength = static_cast<int>(kernel.size());
+
+            std::vector<float> phase0, phase1;
+            for (int i = 0; i < kernelLength; i++)
+            {
+                const float tap = static_cast<float>(kernel[i]);
+                (i % 2 == 0 ? phase0 : phase1).push_back(tap);
+            }
+
+            even.setCoefficients(phase0);
+            odd.setCoefficients(phase1);
+
+            scratch.resize(maxSamplesPerBlock * 4);
+        }
+
+        void reset()
+        {
+            even.reset();
+            odd.reset();
+            lastOdd = 0.0f;
+        }
+
+        /** @return Group delay in input (high-rate) samples */
+        double getLatency() const { return (kernelLength - 1) * 0.5; }
+
+        /**
+         * @param in 2n input samples
+         * @param out n output samples
+         * @param n Number of output samples, at most maxSamplesPerBlock
+         */
+        void processBlock(const float* in, float* out, int n)
+        {
+            float* e = scratch.data();
+            float* o = scratch.data() + n;
+            float* y0 = scratch.data() + n * 2;
+            float* y1 = scratch.data() + n * 3;
+
+            // y[m] = sum h[2k] x[2(m-k)] + sum h[2k+1] x[2(m-k)-1]
+            for (int m = 0; m < n; m++)
+            {
+                e[m] = in[2 * m];
+                o[m] = lastOdd;
+                lastOdd = in[2 * m + 1];
+            }
+
+            even.processBlock(e, y0, n);
+            odd.processBlock(o, y1, n);
+
+            for (int m = 0; m < n; m++) out[m] = y0[m] + y1[m];
+        }
+    };
+}
+
+namespace Ath::Dsp
+{
+    /**
+     * @brief Runs a processor at Factor times the host sample rate.
+     *
+     * Cascades polyphase half-band stages (2x per stage). The first stage uses
+     * the longest kernel; later stages only need to reject images above the
+     * original band, so they get shorter kernels.
+     *
+     * @tparam Factor Oversampling factor: 1, 2, 4 or 8
+     */
+    template <int Factor>
+    class Oversampler
+    {
+        static_assert(Factor == 1 || Factor == 2 || Factor == 4 || Factor == 8, "Oversampling factor must be 1, 2, 4 or 8");
+
+        static constexpr int numberOfStages = Factor == 8 ? 3 : Factor == 4 ? 2 : Factor == 2 ? 1 : 0;
+
+        std::array<Filter::Fir::HalfbandUpsampler, numberOfStages> upsamplers;
+        std::array<Filter::Fir::HalfbandDownsampler, numberOfStages> downsamplers;
+
+        // Stage s (rate 2^(s+1)) writes to rateBuffers[s]
+        std::array<std::vector<float>, numberOfStages> rateBuffers;
+
+        Context c;
+        int maxSamplesPerBlock = 0;
+        int kernelLength = 63;
+
+    public:
+        static constexpr int factor = Factor;
+
+        /**
+         * @brief Set the number of taps of the first stage's half-band kernel.
+         *
+         * Takes effect on the next setContext().
+         */
+        void setKernelLength(int numberOfTaps) { kernelLength = numberOfTaps; }
+
+        /**
+         * @brief Allocate stage buffers for context.maxSamplesPerBlock and build the kernels.
+         */
+        void setContext(const Context context)
+        {
+            c = context;
+            maxSamplesPerBlock = std::max(1, c.maxSamplesPerBlock);
+
+            int taps = kernelLength;
+            for (int s = 0; s < numberOfStages; s++)
+            {
+                const auto kernel = Filter::Fir::HalfbandKernel(taps);
+                const int inputSize = maxSamplesPerBlock << s;
+
+                upsamplers[s].setup(kernel, inputSize);
+                downsamplers[s].setup(kernel, inputSize);
+                rateBuffers[s].resize(inputSize * 2);
+
+                taps = std::max(11, taps / 2);
+            }
+
+            reset();
+        }
+
+        void reset()
+        {
+            for (auto& u : upsamplers) u.reset();
+            for (auto& d : downsamplers) d.reset();
+        }
+
+        /** @return Context of the oversampled processor */
+        Context getOversampledContext() const
+        {
+            return Context(c.SR * Factor, c.maxSamplesPerBlock * Factor);
+        }
+
+        /**
+         * @brief Round-trip latency in host-rate samples, for host delay compensation.
+         */
+        double getLatency() const
+        {
+            double latency = 0.0;
+            for (int s = 0; s < numberOfStages; s++)
+            {
+                const double rate = double(2 << s);
+                latency += (upsamplers[s].getLatency() + downsamplers[s].getLatency()) / rate;
+            }
+            return latency;
+        }
+
+        /**
+         * @brief Upsample, run the processor at the high rate, downsample back in place.
+         *
+         * Before setContext() no buffers exist, and the block is left unchanged.
+         *
+         * @param buffer Host-rate samples
+         * @param n Number of host-rate samples; blocks longer than maxSamplesPerBlock are split
+         * @param processor Callable with (float* samples, int n) or an object with processBlock(float*, int)
+         */
+        template <typename Processor>
+        void processBlock(float* buffer, int n, Processor&& processor)
+        {
+            if (maxSamplesPerBlock <= 0) return;
+
+            for (int start = 0; start < n; start += maxSamplesPerBlock)
+            {
+                const int length = std::min(maxSamplesPerBlock, n - start);
+                processChunk(buffer + start, length, processor);
+            }
+        }
+
+    private:
+        template <typename Processor>
+        void processChunk(float* buffer, int n, Processor& processor)
+        {
+            float* high = buffer;
+            int highLength = n;
+
+            for (int s = 0; s < numberOfStages; s++)
+            {
+                upsamplers[s].processBlock(high, rateBuffers[s].data(), highLength);
+                high = rateBuffers[s].data();
+                highLength *= 2;
+            }
+
+            if constexpr (std::is_invocable_v<Processor&, float*, int>)
+                processor(high, highLength);
+            else
+                processor.processBlock(high, highLength);
+
+            for (int s = numberOfStages - 1; s >= 0; s--)
+            {
+                highLength /= 2;
+                float* low = s == 0 ? buffer : rateBuffers[s - 1].data();
+                downsamplers[s].processBlock(rateBuffers[s].data(), low, highLength);
+            }
+        }
+    };
+}
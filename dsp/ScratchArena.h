@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+#include "Context.h"
+
+namespace Ath::Dsp
+{
+    /**
+     * @brief Preallocated, cache-line-aligned monotonic memory for temporary buffers.
+     *
+     * Sized once in setContext(), from Context::maxSamplesPerBlock, then block
+     * processing takes buffers with allocate() and gives them all back with
+     * reset() at the start of the next block (or with rewind() to a marker,
+     * for buffers that only live inside one stage). Taking a buffer is a
+     * pointer bump, and nothing is freed or allocated on the heap after setup.
+     *
+     * Running out returns nullptr rather than falling back to the heap; the
+     * high-water mark tells how much a processor actually needs.
+     */
+    class ScratchArena
+    {
+    public:
+        static constexpr size_t alignment = 64;
+
+        using Marker = size_t;
+
+    private:
+        std::unique_ptr<std::byte[]> storage;
+        std::byte* base = nullptr;
+
+        size_t capacity = 0;
+        size_t used = 0;
+        size_t highWaterMark = 0;
+
+        static constexpr size_t roundUp(size_t bytes) { return (bytes + alignment - 1) / alignment * alignment; }
+
+    public:
+        /**
+         * @brief Make room for a number of one-channel block buffers of context.maxSamplesPerBlock floats.
+         *
+         * Only allocates if the arena grows. Resets the arena.
+         *
+         * @param numberOfBlockBuffers Buffers that may be in use at the same time
+         */
+        void setContext(const Context context, int numberOfBlockBuffers)
+        {
+            const size_t blockBytes = roundUp(sizeof(float) * static_cast<size_t>(std::max(context.maxSamplesPerBlock, 1)));
+            reserve(blockBytes * static_cast<size_t>(std::max(numberOfBlockBuffers, 0)));
+        }
+
+        /**
+         * @brief Make room for at least this many bytes. Only allocates if the arena grows. Resets the arena.
+         */
+        void reserve(size_t bytes)
+        {
+            bytes = roundUp(bytes);
+
+            if (bytes > capacity)
+            {
+                storage = std::make_unique<std::byte[]>(bytes + alignment);
+
+                const auto address = reinterpret_cast<std::uintptr_t>(storage.get());
+                base = storage.get() + (alignment - address % alignment) % alignment;
+                capacity = bytes;
+            }
+
+            reset();
+        }
+
+        /**
+         * @brief Uninitialised storage for count values, aligned to a cache line.
+         *
+         * @return nullptr if the arena is exhausted
+         */
+        template <typename T>
+        T* allocate(int count)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "Arena values are never destroyed");
+            static_assert(alignof(T) <= alignment, "Type needs more alignment than the arena provides");
+
+            const size_t bytes = roundUp(sizeof(T) * static_cast<size_t>(std::max(count, 0)));
+            if (bytes > capacity - used) return nullptr;
+
+            T* pointer = reinterpret_cast<T*>(base + used);
+            used += bytes;
+            highWaterMark = std::max(highWaterMark, used);
+
+            return pointer;
+        }
+
+        /**
+         * @brief Zero-initialised storage for count values.
+         */
+        template <typename T>
+        T* allocateCleared(int count)
+        {
+            T* pointer = allocate<T>(count);
+            if (pointer) std::fill_n(pointer, count, T {});
+            return pointer;
+        }
+
+        /**
+         * @brief Release everything. Call at the start of each block.
+         */
+        void reset() { used = 0; }
+
+        Marker getMarker() const { return used; }
+
+        /**
+         * @brief Release everything allocated since the marker was taken.
+         */
+        void rewind(Marker marker) { used = std::min(marker, used); }
+
+        size_t getCapacity() const { return capacity; }
+
+        size_t getUsed() const { return used; }
+
+        /** @return Most bytes in use at once since construction */
+        size_t getHighWaterMark() const { return highWaterMark; }
+    };
+}
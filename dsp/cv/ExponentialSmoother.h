@@ -1,32 +1,90 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <type_traits>
+
 #include "../Filter.h"
 
 namespace Ath::Dsp::Cv
 {
+    /**
+     * @brief One-pole smoother: the output approaches the target exponentially.
+     *
+     * Once the distance to the target falls below the settling threshold, or a
+     * step no longer changes the output, it snaps to the target and
+     * isSmoothing() turns false.
+     *
+     * T is a float or a SIMD vector, one smoother per lane; vector lanes
+     * snap independently and isSmoothing() is true while any lane moves.
+     */
     template <typename T>
-    class ExponentialSmoother : private Filter1P<T>
+    class ExponentialSmoother
     {
-        float targetValue = 0.0f;
-        float time = 0.01f;
+        static constexpr int decayTableSize = 16;
+
+        Context c = Context(48000.0f);
+
+        T targetValue = 0.0f;
+        T currentValue = 0.0f;
+
+        /** Time constant in seconds */
+        T time = 0.01f;
+
+        /** One-pole coefficient */
+        T g = 0.0f;
+
+        /** Distance to the target at which the output snaps to it */
+        T threshold = 1e-6f;
+
+        /** (1 - g)^(k + 1): how much of the distance to the target is left after k + 1 samples */
+        std::array<T, decayTableSize> decay {};
+
+        void calculateCoefficients()
+        {
+            g = Filter::timeToG(time, T(c.T));
+
+            T d = T(1.0f) - g;
+            for (auto& power : decay)
+            {
+                power = d;
+                d *= T(1.0f) - g;
+            }
+        }
 
     public:
+        ExponentialSmoother() { calculateCoefficients(); }
 
+        /**
+         * @brief Reset the current and target values to zero.
+         */
         void reset()
         {
-            Filter1P<T>::reset();
+            currentValue = 0.0f;
+            targetValue = 0.0f;
         }
 
         void setContext(const Context context)
         {
-            Filter1P<T>::setContext(context);
-            Filter1P<T>::setTime(time);
+            c = context;
+            calculateCoefficients();
         }
 
+        /**
+         * @param newTime Time constant in seconds
+         */
         virtual void setTime(T newTime)
         {
             time = newTime;
-            Filter1P<T>::setTime(time);
+            calculateCoefficients();
+        }
+
+        /**
+         * @param newThreshold Distance to the target below which the output snaps to it
+         */
+        void setSettlingThreshold(T newThreshold)
+        {
+            threshold = newThreshold;
         }
 
         virtual inline void setTargetValue(T value)
@@ -36,12 +94,35 @@ namespace Ath::Dsp::Cv
 
         inline T last()
         {
-            return Filter1P<T>::last();
+            return currentValue;
+        }
+
+        /**
+         * @brief Check whether the output is still moving toward the target.
+         */
+        inline bool isSmoothing() const
+        {
+            if constexpr (std::is_floating_point_v<T>) return currentValue != targetValue;
+            else return Simd::any(currentValue != targetValue);
         }
 
         virtual inline T process()
         {
-            return Filter1P<T>::process(targetValue);
+            const T previous = currentValue;
+            Filter::Naive::processLP(targetValue, currentValue, g);
+
+            // Rounding can stall the recursion just short of the target
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                if (currentValue == previous || Math::abs(targetValue - currentValue) <= threshold) currentValue = targetValue;
+            }
+            else
+            {
+                const auto settled = (currentValue == previous) | (Simd::abs(targetValue - currentValue) <= threshold);
+                currentValue = Simd::ternary(targetValue, currentValue, settled);
+            }
+
+            return currentValue;
         };
 
         virtual inline T process(const T value)
@@ -49,5 +130,50 @@ namespace Ath::Dsp::Cv
             setTargetValue(value);
             return process();
         }
+
+        /**
+         * @brief Fill a block with the exponential approach to the target, in closed form.
+         *
+         * Runs through the block in chunks of decay table length; each chunk is
+         * independent per sample (target + distance * decay[k]), and the distance
+         * is scaled by the chunk's total decay. A settled smoother only fills
+         * the buffer. Vectors stop early once all lanes have settled.
+         *
+         * @param out Output values
+         * @param n Number of samples
+         */
+        void processBlock(T* out, int n)
+        {
+            if (n <= 0) return;
+
+            if (!isSmoothing())
+            {
+                std::fill_n(out, n, currentValue);
+                return;
+            }
+
+            T distance = currentValue - targetValue;
+
+            for (int i = 0; i < n; i += decayTableSize)
+            {
+                const int m = std::min(decayTableSize, n - i);
+                for (int k = 0; k < m; k++) out[i + k] = targetValue + distance * decay[k];
+
+                distance *= decay[m - 1];
+
+                bool settled;
+                if constexpr (std::is_floating_point_v<T>) settled = Math::abs(distance) <= threshold;
+                else settled = Simd::all(Simd::abs(distance) <= threshold);
+
+                if (settled)
+                {
+                    std::fill(out + i + m, out + n, targetValue);
+                    distance = T(0.0f);
+                    break;
+                }
+            }
+
+            currentValue = targetValue + distance;
+        }
     };
 }
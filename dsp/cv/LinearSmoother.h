@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+
 #include "../Context.h"
 #include "../../math/Math.h"
 
@@ -121,6 +124,60 @@ namespace Ath::Dsp::Cv
             setTargetValue(value);
             return process();
         }
+
+        /**
+         * @brief Check whether the output is still moving toward the target.
+         *
+         * When it is not, callers can use last() as a constant for the whole
+         * block instead of a ramp buffer.
+         */
+        inline bool isSmoothing() const
+        {
+            return currentValue != targetValue;
+        }
+
+        /**
+         * @brief Fill a block with the ramp toward the target, in closed form.
+         *
+         * Same output as calling process() n times: the ramp is at most delta
+         * per sample and holds at the target once reached. A settled smoother
+         * only fills the buffer. Scalar T.
+         *
+         * @param out Output values
+         * @param n Number of samples
+         */
+        void processBlock(T* out, int n)
+        {
+            if (n <= 0) return;
+
+            const T diff = targetValue - currentValue;
+            if (diff == T(0) || !(delta > T(0)))
+            {
+                std::fill_n(out, n, currentValue);
+                return;
+            }
+
+            const T start = currentValue;
+            const T step = diff > T(0) ? delta : -delta;
+
+            // Samples until the target is reached
+            const T steps = Math::abs(diff) / delta;
+
+            if (steps > T(n))
+            {
+                for (int i = 0; i < n; i++) out[i] = start + step * T(i + 1);
+                currentValue = out[n - 1];
+                return;
+            }
+
+            // The last step of the ramp lands exactly on the target
+            const int rampLength = std::max(1, static_cast<int> (std::ceil(steps)));
+
+            for (int i = 0; i < rampLength - 1; i++) out[i] = start + step * T(i + 1);
+            std::fill(out + rampLength - 1, out + n, targetValue);
+
+            currentValue = targetValue;
+        }
     };
 
     /**
@@ -75,9 +75,17 @@ public:
                 if (!gate && filter.last() < 0.01) handleNoteOn(Control::Midi::MessageNoteOn());
             }
 
+            // Stop the decay at -200 dB instead of running into denormals, in the smoothing filter as well
             y *= a;
+            if (y < quiescenceThreshold<T>) y = T(0.0);
             out = filter.process(y * mul + add);
 
+            if (Math::abs(out) < quiescenceThreshold<T>)
+            {
+                filter.reset();
+                out = T(0.0);
+            }
+
             return out;
         }
 
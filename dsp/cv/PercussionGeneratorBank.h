@@ -0,0 +1,216 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "../Context.h"
+#include "../Filter.h"
+#include "../../control/Midi.h"
+#include "../../control/VoiceManager.h"
+#include "../../math/Simd.h"
+
+namespace Ath::Dsp::Cv
+{
+    /**
+     * @brief Voice-parallel PercussionGenerator: one envelope per SIMD lane.
+     *
+     * Same envelope as PercussionGenerator, advanced for a whole vector of
+     * voices per instruction. Gate and tremolo are lane masks, so there are no
+     * per-voice branches; the tremolo retrigger logic is skipped entirely for
+     * groups where no lane has tremolo on.
+     *
+     * Voice i lives in lane i % lanes of group i / lanes, matching the voice
+     * indices of a VoiceManager (see connect). Render only the groups from
+     * VoiceManager::getGroupsToRender(lanes), and report levels back with
+     * reportVoiceLevels() so released voices drop out once they decay.
+     *
+     * @tparam V SIMD float type, e.g. Simd::float8 or Simd::float16
+     * @tparam NumberOfVoices Total voices, a multiple of the vector width
+     */
+    template <typename V, int NumberOfVoices = V::VectorSize>
+    class PercussionGeneratorBank
+    {
+    public:
+        using Mask = Simd::intAnalogOf<V>;
+
+        static constexpr int lanes = V::VectorSize;
+        static constexpr int numberOfGroups = NumberOfVoices / lanes;
+
+        static_assert(NumberOfVoices > 0 && NumberOfVoices % lanes == 0, "NumberOfVoices must be a multiple of the vector width");
+
+    private:
+        struct Group
+        {
+            V y = 0.0f;
+            V filterState = 0.0f;
+            V out = 0.0f;
+
+            Mask gate = 0;
+            Mask tremolo = 0;
+        };
+
+        std::array<Group, numberOfGroups> groups;
+
+        Context c;
+        double time = 1.0;
+
+        V a = 0.9f;
+        V g = 0.0f;
+
+        V add = 0.0f;
+        V mul = 1.0f;
+
+        static Mask laneMask(int lane)
+        {
+            alignas(64) int bits[lanes] = {};
+            bits[lane] = -1;
+            return Mask(bits);
+        }
+
+        inline V processGroup(Group& group)
+        {
+            const V threshold = 0.01f;
+
+            if (Simd::any(group.tremolo))
+            {
+                // Same order as PercussionGenerator: release first, then retrigger once the filter has decayed
+                const Mask release = group.tremolo & group.gate & (group.y < threshold);
+                group.gate = group.gate & ~release;
+
+                const Mask retrigger = group.tremolo & ~group.gate & (group.filterState < threshold);
+                group.y = Simd::ternary(V(1.0f), group.y, retrigger);
+                group.gate = group.gate | retrigger;
+            }
+
+            // Same -200 dB floor as PercussionGenerator
+            group.y *= a;
+            group.y = group.y & (group.y >= V(quiescenceThreshold<float>));
+            Filter::Naive::processLP(group.y * mul + add, group.filterState, g);
+
+            group.filterState = group.filterState & (Simd::abs(group.filterState) >= V(quiescenceThreshold<float>));
+            group.out = group.filterState;
+
+            return group.out;
+        }
+
+    public:
+        void setContext(Context context)
+        {
+            c = context;
+            setTime(time);
+
+            g = Filter::frequencyToG(1000.0f, c.T);
+        }
+
+        /**
+         * @brief Decay time to -20 dB for all voices.
+         */
+        void setTime(double t)
+        {
+            time = std::clamp(t, 0.01, 10.0);
+            const double decayInSamples = time * c.SR;
+            a = float(std::pow(0.1, 1.0 / decayInSamples));
+        }
+
+        void setCrescendo(bool cresc)
+        {
+            add = cresc ? 1.0f : 0.0f;
+            mul = cresc ? -1.0f : 1.0f;
+        }
+
+        void setTremolo(bool trem)
+        {
+            for (auto& group : groups) group.tremolo = trem ? -1 : 0;
+        }
+
+        void setTremolo(int voice, bool trem)
+        {
+            Group& group = groups[voice / lanes];
+            const Mask lane = laneMask(voice % lanes);
+            group.tremolo = trem ? (group.tremolo | lane) : (group.tremolo & ~lane);
+        }
+
+        void handleNoteOn(int voice, Control::Midi::MessageNoteOn message)
+        {
+            Group& group = groups[voice / lanes];
+            const Mask lane = laneMask(voice % lanes);
+
+            group.y = Simd::ternary(V(1.0f), group.y, lane);
+            group.gate = group.gate | lane;
+        }
+
+        void handleNoteOff(int voice, Control::Midi::MessageNoteOff message)
+        {
+            Group& group = groups[voice / lanes];
+            group.gate = group.gate & ~laneMask(voice % lanes);
+        }
+
+        /**
+         * @brief Drive the bank from the voice outputs of a VoiceManager, voice index to voice index.
+         *
+         * @return false if a voice output could not take the connection, so some voices stay unconnected
+         */
+        [[nodiscard]] bool connect(Control::VoiceManager& voiceManager)
+        {
+            const int voices = std::min(NumberOfVoices, voiceManager.getNumberOfVoices());
+
+            bool connected = true;
+            for (int i = 0; i < voices; i++)
+            {
+                connected &= Control::tryAddCallback(voiceManager.noteOn_out(i), [this, i](const Control::Midi::MessageNoteOn& m) { handleNoteOn(i, m); });
+                connected &= Control::tryAddCallback(voiceManager.noteOff_out(i), [this, i](const Control::Midi::MessageNoteOff& m) { handleNoteOff(i, m); });
+            }
+            return connected;
+        }
+
+        /**
+         * @brief Advance one group of voices by one sample.
+         */
+        inline V processSample(int group)
+        {
+            return processGroup(groups[group]);
+        }
+
+        /**
+         * @brief Render n samples of one group of voices, one vector per sample.
+         */
+        void processBlock(int group, V* out, int n)
+        {
+            Group& state = groups[group];
+            for (int i = 0; i < n; i++) out[i] = processGroup(state);
+        }
+
+        /**
+         * @brief Report the output of every voice of a group as its level, so released voices turn silent once decayed.
+         *
+         * Call after rendering the group; groups that were not rendered keep their last levels.
+         */
+        void reportVoiceLevels(int group, Control::VoiceManager& voiceManager) const
+        {
+            alignas(64) float levels[lanes];
+            groups[group].out.storeUnaligned(levels);
+
+            const int voices = std::min(NumberOfVoices, voiceManager.getNumberOfVoices());
+
+            for (int lane = 0; lane < lanes; lane++)
+            {
+                const int voice = group * lanes + lane;
+                if (voice < voices) voiceManager.setVoiceLevel(voice, std::abs(levels[lane]));
+            }
+        }
+
+        /**
+         * @return 1 for lanes whose gate is open, 0 otherwise
+         */
+        inline V getGate(int group) const
+        {
+            return V(1.0f) & groups[group].gate;
+        }
+
+        inline V last(int group) const
+        {
+            return groups[group].out;
+        }
+    };
+}
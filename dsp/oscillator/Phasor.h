@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cmath>
+#include <type_traits>
+
+#include "../Context.h"
+#include "../../math/Math.h"
+#include "../../math/Simd.h"
+
+namespace Ath::Dsp::Oscillator
+{
+    /**
+     * Helpers that work on scalars and on SIMD vectors alike.
+     */
+    namespace Detail
+    {
+        template <typename V>
+        using Mask = Simd::intAnalogOf<V>;
+
+        template <typename V>
+        static inline V select(Mask<V> mask, V a, V b)
+        {
+            if constexpr (std::is_floating_point_v<V>) return mask ? a : b;
+            else return Simd::ternary(a, b, mask);
+        }
+
+        /// Fractional part, in [0, 1) for any sign
+        template <typename V>
+        static inline V wrap(V x)
+        {
+            if constexpr (std::is_floating_point_v<V>) return x - std::floor(x);
+            else return x - Simd::floor(x);
+        }
+    }
+
+    /**
+     * @brief Phase accumulator with a wrapped phase in [0, 1), one oscillator per lane.
+     *
+     * Unlike PhaseCounter, which accumulates seconds, the phase stays bounded,
+     * so float precision does not degrade over time. With a SIMD type every
+     * lane is an independent oscillator (voice).
+     *
+     * @tparam V float or a SIMD float type
+     */
+    template <typename V>
+    class Phasor
+    {
+        Context c = Context(48000.0f);
+
+        V frequency = 0.0f;
+        V phase = 0.0f;
+        V increment = 0.0f;
+
+    public:
+        void setContext(Context context)
+        {
+            c = context;
+            setFrequency(frequency);
+        }
+
+        /**
+         * @param hz Frequency per lane, below Nyquist
+         */
+        void setFrequency(V hz)
+        {
+            frequency = hz;
+            increment = hz * V(c.T);
+        }
+
+        void setPhase(V newPhase) { phase = Detail::wrap(newPhase); }
+
+        void reset() { phase = 0.0f; }
+
+        /** Phase increment per sample, in cycles */
+        inline V getIncrement() const { return increment; }
+
+        inline V getPhase() const { return phase; }
+
+        /**
+         * @return Phase of the current sample, then advance by one sample
+         */
+        inline V processSample()
+        {
+            const V current = phase;
+            phase = Detail::wrap(phase + increment);
+            return current;
+        }
+
+        /**
+         * @brief Write the phases of the next n samples.
+         */
+        void processBlock(V* out, int n)
+        {
+            V p = phase;
+            const V inc = increment;
+
+            for (int i = 0; i < n; i++)
+            {
+                out[i] = p;
+                p = Detail::wrap(p + inc);
+            }
+
+            phase = p;
+        }
+    };
+
+    /**
+     * @brief Sine oscillator on a Phasor, using the 9th-order sin2pi approximation.
+     */
+    template <typename V>
+    class SineOscillator
+    {
+        Phasor<V> phasor;
+
+        // sin(2pi p) = -sin(2pi (p - 0.5)), and p - 0.5 is in the [-0.5, 0.5) range of sin2pi9
+        static inline V sine(V p) { return -Math::sin2pi9(p - V(0.5f)); }
+
+    public:
+        void setContext(Context context) { phasor.setContext(context); }
+
+        void setFrequency(V hz) { phasor.setFrequency(hz); }
+
+        void setPhase(V newPhase) { phasor.setPhase(newPhase); }
+
+        void reset() { phasor.reset(); }
+
+        inline V processSample() { return sine(phasor.processSample()); }
+
+        void processBlock(V* out, int n)
+        {
+            phasor.processBlock(out, n);
+            for (int i = 0; i < n; i++) out[i] = sine(out[i]);
+        }
+    };
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Phasor.h"
+
+namespace Ath::Dsp::Oscillator
+{
+    /**
+     * @brief Two-sample polynomial band-limited step residual.
+     *
+     * Correction to subtract from a naive unit step at phase 0 (to add, for a
+     * step down). Branch-free, so it works per lane on SIMD types.
+     *
+     * @param t Phase in [0, 1)
+     * @param dt Phase increment per sample
+     * @param invDt 1 / dt
+     */
+    template <typename V>
+    static inline V polyBlep(V t, V dt, V invDt)
+    {
+        // Just after the discontinuity
+        const V a = t * invDt;
+        const V after = a + a - a * a - V(1.0f);
+
+        // Just before it
+        const V b = (t - V(1.0f)) * invDt;
+        const V before = b * b + b + b + V(1.0f);
+
+        return Detail::select(t < dt, after, Detail::select(t > V(1.0f) - dt, before, V(0.0f)));
+    }
+
+    /**
+     * @brief Saw and square oscillators with polyBLEP anti-aliasing, one oscillator per lane.
+     */
+    template <typename V>
+    class PolyBlepOscillator
+    {
+    public:
+        enum class Waveform { Saw, Square };
+
+    private:
+        Phasor<V> phasor;
+        Waveform waveform = Waveform::Saw;
+
+        V invIncrement = 0.0f;
+
+        void updateIncrement()
+        {
+            // Lanes at 0 Hz never reach the blep branches
+            const V dt = phasor.getIncrement();
+            invIncrement = Detail::select(dt > V(0.0f), V(1.0f) / dt, V(0.0f));
+        }
+
+        template <Waveform W>
+        inline V shape(V p, V dt, V invDt) const
+        {
+            if constexpr (W == Waveform::Saw)
+            {
+                return p + p - V(1.0f) - polyBlep(p, dt, invDt);
+            }
+            else
+            {
+                const V naive = Detail::select(p < V(0.5f), V(1.0f), V(-1.0f));
+                return naive + polyBlep(p, dt, invDt) - polyBlep(Detail::wrap(p + V(0.5f)), dt, invDt);
+            }
+        }
+
+        template <Waveform W>
+        void processBlockInternal(V* out, int n)
+        {
+            const V dt = phasor.getIncrement();
+            const V invDt = invIncrement;
+
+            phasor.processBlock(out, n);
+            for (int i = 0; i < n; i++) out[i] = shape<W>(out[i], dt, invDt);
+        }
+
+    public:
+        void setContext(Context context)
+        {
+            phasor.setContext(context);
+            updateIncrement();
+        }
+
+        void setFrequency(V hz)
+        {
+            phasor.setFrequency(hz);
+            updateIncrement();
+        }
+
+        void setWaveform(Waveform newWaveform) { waveform = newWaveform; }
+
+        void setPhase(V newPhase) { phasor.setPhase(newPhase); }
+
+        void reset() { phasor.reset(); }
+
+        inline V processSample()
+        {
+            const V dt = phasor.getIncrement();
+            const V p = phasor.processSample();
+
+            return waveform == Waveform::Saw ? shape<Waveform::Saw>(p, dt, invIncrement)
+                                             : shape<Waveform::Square>(p, dt, invIncrement);
+        }
+
+        void processBlock(V* out, int n)
+        {
+            if (waveform == Waveform::Saw) processBlockInternal<Waveform::Saw>(out, n);
+            else processBlockInternal<Waveform::Square>(out, n);
+        }
+    };
+}
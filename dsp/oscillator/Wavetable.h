@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "Phasor.h"
+#include "../../math/Fft.h"
+
+namespace Ath::Dsp::Oscillator
+{
+    /**
+     * @brief Mipmapped band-limited wavetable built from one cycle of a waveform.
+     *
+     * Level k keeps the harmonics up to size / 2^(k + 1), so it plays without
+     * aliasing up to a phase increment of 2^k / size cycles per sample. The
+     * levels are made once, by zeroing bins of the cycle's spectrum (Math::Fft),
+     * and stored contiguously with two guard samples each, so every lookup is
+     * one interpolated read (one gather per neighbour on SIMD types).
+     *
+     * Build once at init and share between voices; reading is const.
+     */
+    class Wavetable
+    {
+        int size = 0;
+        int stride = 0;
+        int numberOfLevels = 0;
+
+        std::vector<float> samples;
+
+        template <typename V>
+        using IndexType = std::conditional_t<std::is_floating_point_v<V>, int, Simd::intAnalogOf<V>>;
+
+    public:
+        /**
+         * @param cycle One period of the waveform; its length must be a power of two, at least 8
+         */
+        explicit Wavetable(std::span<const float> cycle)
+        {
+            size = static_cast<int>(cycle.size());
+            stride = size + 2;
+            for (int h = size / 2; h >= 1; h /= 2) numberOfLevels++;
+
+            Math::Fft fft;
+            fft.setSize(size);
+
+            const int bins = size / 2 + 1;
+            std::vector<float> re(bins), im(bins), levelRe(bins), levelIm(bins);
+            fft.forwardReal(cycle.data(), re.data(), im.data());
+
+            samples.resize(static_cast<size_t>(stride) * numberOfLevels);
+
+            for (int level = 0; level < numberOfLevels; level++)
+            {
+                // The Nyquist bin is ambiguous in phase, level 0 stops one bin below it
+                const int highest = level == 0 ? size / 2 - 1 : (size / 2) >> level;
+
+                for (int k = 0; k < bins; k++)
+                {
+                    levelRe[k] = k <= highest ? re[k] : 0.0f;
+                    levelIm[k] = k <= highest ? im[k] : 0.0f;
+                }
+
+                float* data = samples.data() + static_cast<size_t>(stride) * level;
+                fft.inverseReal(levelRe.data(), levelIm.data(), data);
+
+                data[size] = data[0];
+                data[size + 1] = data[1];
+            }
+        }
+
+        /**
+         * @brief Tabulate one cycle of a function.
+         *
+         * @param f Callable float(float phase), phase in [0, 1)
+         * @param size Samples per cycle, power of two
+         */
+        template <typename F>
+        static Wavetable fromFunction(F&& f, int size = 2048)
+        {
+            std::vector<float> cycle(size);
+            for (int i = 0; i < size; i++) cycle[i] = f(float(i) / float(size));
+            return Wavetable(cycle);
+        }
+
+        int getSize() const { return size; }
+
+        int getNumberOfLevels() const { return numberOfLevels; }
+
+        /**
+         * @brief Offset of the level to use for a phase increment, to pass to read().
+         *
+         * @param increment Phase increment in cycles per sample, per lane
+         */
+        template <typename V>
+        IndexType<V> getLevelOffset(V increment) const
+        {
+            if constexpr (std::is_floating_point_v<V>)
+            {
+                const V level = std::ceil(std::log2(std::max(increment * V(size), V(1.0f))));
+                return static_cast<int>(std::min(level, V(numberOfLevels - 1))) * stride;
+            }
+            else
+            {
+                const V level = Simd::ceil(Simd::fastLog2(Simd::max(increment * V(float(size)), V(1.0f))));
+                return Simd::toInt(Simd::min(level, V(float(numberOfLevels - 1)))) * IndexType<V>(stride);
+            }
+        }
+
+        /**
+         * @brief Linearly interpolated read.
+         *
+         * @param phase Phase in [0, 1), per lane
+         * @param levelOffset From getLevelOffset(), per lane
+         */
+        template <typename V>
+        inline V read(V phase, IndexType<V> levelOffset) const noexcept
+        {
+            const V x = phase * V(float(size));
+
+            if constexpr (std::is_floating_point_v<V>)
+            {
+                const int i = static_cast<int>(x);
+                const V fraction = x - V(i);
+                const float* p = samples.data() + levelOffset + i;
+                return p[0] + (p[1] - p[0]) * fraction;
+            }
+            else
+            {
+                const auto i = Simd::toInt(x);
+                const V fraction = x - Simd::toFloat(i);
+                const auto index = i + levelOffset;
+
+                const V y0 = Simd::gather(samples.data(), index);
+                const V y1 = Simd::gather(samples.data(), index + IndexType<V>(1));
+                return y0 + (y1 - y0) * fraction;
+            }
+        }
+    };
+
+    /**
+     * @brief Wavetable oscillator on a Phasor, picking the mipmap level per lane from its frequency.
+     */
+    template <typename V>
+    class WavetableOscillator
+    {
+        using IndexType = std::conditional_t<std::is_floating_point_v<V>, int, Simd::intAnalogOf<V>>;
+
+        std::shared_ptr<const Wavetable> table;
+        Phasor<V> phasor;
+        IndexType levelOffset = 0;
+
+        void updateLevel()
+        {
+            if (table) levelOffset = table->getLevelOffset(phasor.getIncrement());
+        }
+
+    public:
+        void setTable(std::shared_ptr<const Wavetable> newTable)
+        {
+            table = std::move(newTable);
+            updateLevel();
+        }
+
+        void setContext(Context context)
+        {
+            phasor.setContext(context);
+            updateLevel();
+        }
+
+        void setFrequency(V hz)
+        {
+            phasor.setFrequency(hz);
+            updateLevel();
+        }
+
+        void setPhase(V newPhase) { phasor.setPhase(newPhase); }
+
+        void reset() { phasor.reset(); }
+
+        /**
+         * @brief Requires a table.
+         */
+        inline V processSample()
+        {
+            return table->read(phasor.processSample(), levelOffset);
+        }
+
+        /**
+         * @brief Requires a table.
+         */
+        void processBlock(V* out, int n)
+        {
+            const Wavetable& t = *table;
+
+            phasor.processBlock(out, n);
+            for (int i = 0; i < n; i++) out[i] = t.read(out[i], levelOffset);
+        }
+    };
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#include "../../math/Simd.h"
+
+namespace Ath::Dsp::Waveshaper
+{
+    /**
+     * @brief First-order ADAA with static polymorphism (CRTP).
+     *
+     * Same algorithm as ADAA1 / ADAA1simd, but the nonlinearity and its
+     * antiderivative are resolved at compile time from Derived, so the
+     * compiler can inline them and vectorize the block loops.
+     *
+     * Derived must provide:
+     *  - T nonlinearity (T x) const noexcept
+     *  - T nonlinearityAntiderivative (T x) const noexcept
+     *
+     * T may be a scalar (float, double) or a SIMD vector (one voice per lane).
+     */
+    template <typename Derived, typename T>
+    class ADAA1static
+    {
+        static constexpr bool isDouble = std::is_same_v<T, double>;
+
+        inline const Derived& derived() const noexcept { return static_cast<const Derived&>(*this); }
+
+    public:
+        /**
+         * Smallest |x - xPrev|, relative to max(|x|, 1), for the antiderivative
+         * difference. Float lanes lose about 23 bits of F(x) - F(xPrev) to
+         * cancellation, so anything smaller falls back to the midpoint; only
+         * double carries enough precision for 1e-8.
+         */
+        static constexpr float TOL = isDouble ? 1.0e-8f : 1.0e-4f;
+
+        void reset()
+        {
+            x1 = 0.0;
+            ad1_x1 = 0.0;
+            monoX1 = 0.0f;
+            monoAd1X1 = 0.0f;
+        }
+
+        inline T process (T x) noexcept
+        {
+            const T ad1_x = derived().nonlinearityAntiderivative (x);
+            const T y = evaluate (x, x1, ad1_x, ad1_x1);
+
+            ad1_x1 = ad1_x;
+            x1 = x;
+
+            return y;
+        }
+
+        /**
+         * @brief Process a block, one T per frame. State is kept in locals across the loop.
+         *
+         * @param in Input frames
+         * @param out Output frames (may alias in)
+         * @param n Number of frames
+         */
+        void processBlock (const T* in, T* out, int n) noexcept
+        {
+            T xPrev = x1;
+            T adPrev = ad1_x1;
+
+            for (int i = 0; i < n; i++)
+            {
+                const T x = in[i];
+                const T ad = derived().nonlinearityAntiderivative (x);
+
+                out[i] = evaluate (x, xPrev, ad, adPrev);
+
+                xPrev = x;
+                adPrev = ad;
+            }
+
+            x1 = xPrev;
+            ad1_x1 = adPrev;
+        }
+
+        void processBlock (T* buffer, int n) noexcept { processBlock (buffer, buffer, n); }
+
+        /**
+         * @brief Process a single mono stream, 8 consecutive samples per float8.
+         *
+         * The previous-sample vectors are built by rotating the current vector
+         * by one lane and inserting the last sample of the previous group, so the
+         * antiderivative is evaluated once per sample. Only available for T = float8.
+         * This stream has its own state, separate from the per-voice one.
+         *
+         * @param in Input samples
+         * @param out Output samples (may alias in)
+         * @param n Number of samples
+         */
+        void processBlockMono (const float* in, float* out, int n) noexcept
+        {
+            static_assert (std::is_same_v<T, Simd::float8>, "processBlockMono requires T = Simd::float8");
+
+            const Simd::int8 lastLane = 7;
+
+            Simd::float8 xCarry = monoX1;
+            Simd::float8 adCarry = monoAd1X1;
+
+            auto step = [&] (Simd::float8 x) -> Simd::float8
+            {
+                const Simd::float8 ad = derived().nonlinearityAntiderivative (x);
+
+                const Simd::float8 xPrev = Simd::ternary (xCarry, Simd::permute (x, Simd::perm7), Simd::mask1);
+                const Simd::float8 adPrev = Simd::ternary (adCarry, Simd::permute (ad, Simd::perm7), Simd::mask1);
+
+                xCarry = Simd::permute (x, lastLane);
+                adCarry = Simd::permute (ad, lastLane);
+
+                return evaluate (x, xPrev, ad, adPrev);
+            };
+
+            int i = 0;
+            for (; i + 8 <= n; i += 8)
+                step (Simd::float8::loadUnaligned (in + i)).storeUnaligned (out + i);
+
+            if (i < n)
+            {
+                // Pad the tail with its last sample so the carried state ends on it
+                alignas(32) float tail[8];
+                for (int k = 0; k < 8; k++) tail[k] = in[std::min (i + k, n - 1)];
+
+                step (Simd::float8 (tail)).store (tail);
+
+                for (int k = 0; i + k < n; k++) out[i + k] = tail[k];
+            }
+
+            monoX1 = xCarry[0];
+            monoAd1X1 = adCarry[0];
+        }
+
+    protected:
+        T x1 = 0.0;
+        T ad1_x1 = 0.0;
+
+        float monoX1 = 0.0f;
+        float monoAd1X1 = 0.0f;
+
+    private:
+        template <typename V>
+        inline V evaluate (V x, V xPrev, V ad, V adPrev) const noexcept
+        {
+            if constexpr (std::is_floating_point_v<V>)
+            {
+                if (std::abs (x - xPrev) < V(TOL) * std::max (std::abs (x), V(1)))
+                    return derived().nonlinearity (V(0.5) * (x + xPrev));
+
+                return (ad - adPrev) / (x - xPrev);
+            }
+            else
+            {
+                const V diff = x - xPrev;
+                const auto illCondition = Simd::abs (diff) < V(TOL) * Simd::max (Simd::abs (x), V(1.0f));
+
+                const V branch1 = (ad - adPrev) / diff;
+
+                // Only evaluate the fallback when at least one lane needs it
+                if (!Simd::any (illCondition)) return branch1;
+
+                const V branch2 = derived().nonlinearity ((x + xPrev) * V(0.5f));
+
+                return Simd::ternary (branch2, branch1, illCondition);
+            }
+        }
+    };
+}
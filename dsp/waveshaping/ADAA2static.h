@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cmath>
+#include <type_traits>
+
+#include "../../math/Simd.h"
+
+namespace Ath::Dsp::Waveshaper
+{
+    /**
+     * @brief Second-order ADAA with static polymorphism (CRTP).
+     *
+     * Uses the second antiderivative to suppress aliasing further than ADAA1,
+     * at the cost of one sample of delay.
+     *
+     * Derived must provide:
+     *  - T nonlinearity (T x) const noexcept
+     *  - T nonlinearityAntiderivative (T x) const noexcept
+     *  - T nonlinearityAntiderivative2 (T x) const noexcept
+     *
+     * T may be a scalar (float, double) or a SIMD vector (one voice per lane).
+     */
+    template <typename Derived, typename T>
+    class ADAA2static
+    {
+        inline const Derived& derived() const noexcept { return static_cast<const Derived&>(*this); }
+
+        struct State
+        {
+            T x1, x2;       // previous inputs
+            T ad2_x1;       // second antiderivative at x1
+            T d2;           // previous first-order divided difference
+        };
+
+    public:
+        // Float differences of the second antiderivative lose precision quickly, so the
+        // fallback takes over earlier than in double
+        static constexpr float TOL = std::is_same_v<T, double> ? 1.0e-5f : 1.0e-2f;
+
+        void reset()
+        {
+            x1 = 0.0;
+            x2 = 0.0;
+            ad2_x1 = derived().nonlinearityAntiderivative2 (T(0.0f));
+            d2 = derived().nonlinearityAntiderivative (T(0.0f));
+        }
+
+        inline T process (T x) noexcept
+        {
+            State s { x1, x2, ad2_x1, d2 };
+            const T y = step (x, s);
+
+            x1 = s.x1; x2 = s.x2; ad2_x1 = s.ad2_x1; d2 = s.d2;
+            return y;
+        }
+
+        /**
+         * @brief Process a block, one T per frame. State is kept in locals across the loop.
+         *
+         * @param in Input frames
+         * @param out Output frames (may alias in)
+         * @param n Number of frames
+         */
+        void processBlock (const T* in, T* out, int n) noexcept
+        {
+            State s { x1, x2, ad2_x1, d2 };
+
+            for (int i = 0; i < n; i++) out[i] = step (in[i], s);
+
+            x1 = s.x1; x2 = s.x2; ad2_x1 = s.ad2_x1; d2 = s.d2;
+        }
+
+        void processBlock (T* buffer, int n) noexcept { processBlock (buffer, buffer, n); }
+
+    protected:
+        T x1 = 0.0;
+        T x2 = 0.0;
+        T ad2_x1 = 0.0;
+        T d2 = 0.0;
+
+    private:
+        inline T step (T x, State& s) const noexcept
+        {
+            const T ad2_x = derived().nonlinearityAntiderivative2 (x);
+
+            T y;
+
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                const T d1 = std::abs (x - s.x1) < T(TOL)
+                    ? derived().nonlinearityAntiderivative (T(0.5) * (x + s.x1))
+                    : (ad2_x - s.ad2_x1) / (x - s.x1);
+
+                if (std::abs (x - s.x2) < T(TOL))
+                {
+                    // Fallback around the midpoint of x and x2
+                    const T xBar = T(0.5) * (x + s.x2);
+                    const T delta = xBar - s.x1;
+
+                    y = std::abs (delta) < T(TOL)
+                        ? derived().nonlinearity (T(0.5) * (xBar + s.x1))
+                        : (T(2.0) / delta) * (derived().nonlinearityAntiderivative (xBar)
+                                               + (s.ad2_x1 - derived().nonlinearityAntiderivative2 (xBar)) / delta);
+                }
+                else
+                {
+                    y = (T(2.0) / (x - s.x2)) * (d1 - s.d2);
+                }
+
+                s.d2 = d1;
+            }
+            else
+            {
+                const T tol = T(TOL);
+                const T half = T(0.5f);
+
+                const auto ill1 = Simd::abs (x - s.x1) < tol;
+                T d1 = (ad2_x - s.ad2_x1) / (x - s.x1);
+                if (Simd::any (ill1))
+                    d1 = Simd::ternary (derived().nonlinearityAntiderivative ((x + s.x1) * half), d1, ill1);
+
+                const auto ill2 = Simd::abs (x - s.x2) < tol;
+                y = (d1 - s.d2) * T(2.0f) / (x - s.x2);
+
+                if (Simd::any (ill2))
+                {
+                    const T xBar = (x + s.x2) * half;
+                    const T delta = xBar - s.x1;
+
+                    const auto ill3 = Simd::abs (delta) < tol;
+                    T fallback = (derived().nonlinearityAntiderivative (xBar)
+                                  + (s.ad2_x1 - derived().nonlinearityAntiderivative2 (xBar)) / delta) * T(2.0f) / delta;
+                    if (Simd::any (ill3))
+                        fallback = Simd::ternary (derived().nonlinearity ((xBar + s.x1) * half), fallback, ill3);
+
+                    y = Simd::ternary (fallback, y, ill2);
+                }
+
+                s.d2 = d1;
+            }
+
+            s.x2 = s.x1;
+            s.x1 = x;
+            s.ad2_x1 = ad2_x;
+
+            return y;
+        }
+    };
+}
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "ADAA1simd.h"
+#include "ADAA1static.h"
 #include "../../math/Simd.h"
 #include <cmath>
 
@@ -18,9 +18,17 @@ namespace Ath::Dsp::Waveshaper
         }
     }
 
+    /**
+     * @brief Polynomial soft clipper x - x^N, scaled to reach ±1 at its peak, with first-order ADAA.
+     *
+     * Built on the static ADAA base, so processBlock() and processBlockMono()
+     * inline the nonlinearity instead of calling it through a vtable.
+     */
     template<int N, typename T>
-    class SoftClipperSimd : public ADAA1simd<T>
+    class SoftClipperSimd : public ADAA1static<SoftClipperSimd<N, T>, T>
     {
+        friend class ADAA1static<SoftClipperSimd<N, T>, T>;
+
         const T k = std::pow(1.0f / float(N), 1.0f / (float(N) - 1.0f));
         const T l = f(k);
         const T rl = T(1.0f) / l;
@@ -28,10 +36,12 @@ namespace Ath::Dsp::Waveshaper
 
         const T rn1 = T(1.0f) / (T(N) + 1.0f);
 
+        const T offset = f2(k) * rkl - 1.0f;
+
         inline T f(T x) const { return x - ipow<N>(x); }
         inline T f2(T x) const { return (x * x) * 0.5f - ipow<N + 1>(x) * rn1; }
 
-        inline T nonlinearity (T x) const noexcept override
+        inline T nonlinearity (T x) const noexcept
         {
             const T y0 = -1.0f;
             const T y1 = f(x * k) * rl;
@@ -40,10 +50,8 @@ namespace Ath::Dsp::Waveshaper
             return Simd::ternary(Simd::ternary(y0, y1, x < -1.0f), y2, x < 1.0f);
         }
 
-        inline T nonlinearityAntiderivative (T x) const noexcept override
+        inline T nonlinearityAntiderivative (T x) const noexcept
         {
-            static const T offset = f2(k) * rkl - 1.0f;
-
             const T y0 = -x + offset;
             const T y1 = f2(x * k) * rkl;
             const T y2 = x + offset;
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "ADAA1static.h"
+#include "ADAA2static.h"
+#include "../../math/Polynomial.h"
+#include "../../math/Simd.h"
+
+namespace Ath::Dsp::Waveshaper
+{
+    /**
+     * @brief Piecewise-cubic table of a nonlinearity and its first two antiderivatives.
+     *
+     * On each of the uniform segments over [minX, maxX] the nonlinearity is
+     * interpolated by a cubic through 4 equally spaced points. The antiderivatives
+     * come from Math::Polynomial::antiderivative() with integration constants
+     * carried across segments, so they are continuous and exact for the
+     * interpolant. Both are anchored to 0 at x = 0 to keep them small.
+     * Outside the range the nonlinearity is held at its boundary value and the
+     * antiderivatives continue as the matching linear and quadratic extensions.
+     *
+     * Coefficients are stored per degree (SoA), so SIMD lookups are one gather per coefficient.
+     * Build once at init and share between instances; evaluation is read-only.
+     */
+    class TabulatedNonlinearity
+    {
+        using Poly0 = Math::Polynomial<double, 4>;
+        using Poly1 = Math::Polynomial<double, 5>;
+        using Poly2 = Math::Polynomial<double, 6>;
+
+        float minX = -1.0f;
+        float maxX = 1.0f;
+        float invSegmentLength = 1.0f;
+        int numberOfSegments = 0;
+
+        // Segment 0 extends below minX, segment numberOfSegments + 1 above maxX
+        std::vector<float> base;
+        std::array<std::vector<float>, 4> f0;
+        std::array<std::vector<float>, 5> f1;
+        std::array<std::vector<float>, 6> f2;
+
+        template <int N>
+        void store(int segment, const Math::Polynomial<double, N>& p, std::array<std::vector<float>, N>& table)
+        {
+            for (int i = 0; i < N; i++) table[i][segment] = static_cast<float>(p.coefficients[i]);
+        }
+
+        // Cubic through (0, y0), (h/3, y1), (2h/3, y2), (h, y3), coefficients highest degree first
+        static Poly0 fitCubic(double h, double y0, double y1, double y2, double y3)
+        {
+            // Newton divided differences on the normalized abscissa t = 3u/h in {0, 1, 2, 3}
+            const double d1 = y1 - y0;
+            const double d2 = (y2 - 2.0 * y1 + y0) * 0.5;
+            const double d3 = (y3 - 3.0 * y2 + 3.0 * y1 - y0) / 6.0;
+
+            // p(t) = y0 + d1 t + d2 t(t-1) + d3 t(t-1)(t-2)
+            const double c0 = y0;
+            const double c1 = d1 - d2 + 2.0 * d3;
+            const double c2 = d2 - 3.0 * d3;
+            const double c3 = d3;
+
+            const double s = 3.0 / h;
+            return Poly0 { { c3 * s * s * s, c2 * s * s, c1 * s, c0 } };
+        }
+
+        template <typename T>
+        inline void locate(T x, T& u, auto& index) const noexcept
+        {
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                const T position = std::floor((x - T(minX)) * T(invSegmentLength)) + T(1.0);
+                const T clamped = std::min(std::max(position, T(0.0)), T(numberOfSegments + 1));
+                index = static_cast<int>(clamped);
+                u = x - T(base[index]);
+            }
+            else
+            {
+                const T position = Simd::floor((x - T(minX)) * T(invSegmentLength)) + T(1.0f);
+                const T clamped = Simd::min(Simd::max(position, T(0.0f)), T(float(numberOfSegments + 1)));
+                index = Simd::toInt(clamped);
+                u = x - Simd::gather(base.data(), index);
+            }
+        }
+
+        template <typename T, int N>
+        inline T horner(const std::array<std::vector<float>, N>& table, T u, auto index) const noexcept
+        {
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                T y = T(table[0][index]);
+                for (int i = 1; i < N; i++) y = y * u + T(table[i][index]);
+                return y;
+            }
+            else
+            {
+                T y = Simd::gather(table[0].data(), index);
+                for (int i = 1; i < N; i++) y = Simd::fma(y, u, Simd::gather(table[i].data(), index));
+                return y;
+            }
+        }
+
+        template <typename T>
+        using IndexType = std::conditional_t<std::is_floating_point_v<T>, int, Simd::intAnalogOf<T>>;
+
+    public:
+        /**
+         * @brief Tabulate a nonlinearity.
+         *
+         * @param f Callable double(double)
+         * @param newMinX Lower end of the tabulated range
+         * @param newMaxX Upper end of the tabulated range
+         * @param segments Number of cubic segments
+         */
+        template <typename F>
+        void build(F&& f, float newMinX, float newMaxX, int segments)
+        {
+            minX = newMinX;
+            maxX = newMaxX;
+            numberOfSegments = segments;
+
+            const double h = (double(maxX) - double(minX)) / double(segments);
+            invSegmentLength = static_cast<float>(1.0 / h);
+
+            const int size = segments + 2;
+
+            std::vector<double> x0(size);
+            std::vector<Poly0> p0(size);
+            std::vector<Poly1> p1(size);
+            std::vector<Poly2> p2(size);
+
+            // Integrate upwards from minX, constants carried across segments
+            double c1 = 0.0;
+            double c2 = 0.0;
+
+            // Below range: f held at f(minX)
+            const double fMin = f(double(minX));
+            x0[0] = minX;
+            p0[0] = Poly0 { { 0.0, 0.0, 0.0, fMin } };
+
+            for (int k = 0; k <= segments; k++)
+            {
+                const int segment = k + 1;
+
+                if (k < segments)
+                {
+                    const double start = double(minX) + h * k;
+                    x0[segment] = start;
+                    p0[segment] = fitCubic(h, f(start), f(start + h / 3.0), f(start + 2.0 * h / 3.0), f(start + h));
+                }
+                else
+                {
+                    // Above range: f held at f(maxX)
+                    x0[segment] = maxX;
+                    p0[segment] = Poly0 { { 0.0, 0.0, 0.0, f(double(maxX)) } };
+                }
+
+                p1[segment] = p0[segment].antiderivative();
+                p1[segment].coefficients[4] = c1;
+
+                p2[segment] = p1[segment].antiderivative();
+                p2[segment].coefficients[5] = c2;
+
+                c1 = p1[segment].evaluate(h);
+                c2 = p2[segment].evaluate(h);
+            }
+
+            p1[0] = p0[0].antiderivative();
+            p2[0] = p1[0].antiderivative();
+
+            // Re-anchor both antiderivatives to 0 at x = 0 (or the nearest range end),
+            // which keeps their magnitudes small and the ADAA differences accurate in float
+            const double anchor = std::min(std::max(0.0, double(minX)), double(maxX));
+            const int anchorSegment = std::min(int((anchor - minX) / h) + 1, segments);
+            const double ua = anchor - x0[anchorSegment];
+            const double a1 = p1[anchorSegment].evaluate(ua);
+            const double a2 = p2[anchorSegment].evaluate(ua);
+
+            base.assign(size, 0.0f);
+            for (auto& t : f0) t.assign(size, 0.0f);
+            for (auto& t : f1) t.assign(size, 0.0f);
+            for (auto& t : f2) t.assign(size, 0.0f);
+
+            for (int k = 0; k < size; k++)
+            {
+                // F1' = F1 - a1, F2' = F2 - a2 - a1 (x - anchor) with x = x0 + u
+                p1[k].coefficients[4] -= a1;
+                p2[k].coefficients[4] -= a1;
+                p2[k].coefficients[5] -= a2 + a1 * (x0[k] - anchor);
+
+                base[k] = static_cast<float>(x0[k]);
+                store<4>(k, p0[k], f0);
+                store<5>(k, p1[k], f1);
+                store<6>(k, p2[k], f2);
+            }
+        }
+
+        template <typename T>
+        inline T evaluate(T x) const noexcept
+        {
+            T u; IndexType<T> index;
+            locate(x, u, index);
+            return horner<T, 4>(f0, u, index);
+        }
+
+        template <typename T>
+        inline T evaluateAntiderivative(T x) const noexcept
+        {
+            T u; IndexType<T> index;
+            locate(x, u, index);
+            return horner<T, 5>(f1, u, index);
+        }
+
+        template <typename T>
+        inline T evaluateAntiderivative2(T x) const noexcept
+        {
+            T u; IndexType<T> index;
+            locate(x, u, index);
+            return horner<T, 6>(f2, u, index);
+        }
+    };
+
+    /**
+     * @brief First-order ADAA waveshaper driven by a shared TabulatedNonlinearity.
+     */
+    template <typename T>
+    class TabulatedADAA1 : public ADAA1static<TabulatedADAA1<T>, T>
+    {
+        friend class ADAA1static<TabulatedADAA1<T>, T>;
+
+        std::shared_ptr<const TabulatedNonlinearity> table;
+
+        inline T nonlinearity (T x) const noexcept { return table->evaluate(x); }
+        inline T nonlinearityAntiderivative (T x) const noexcept { return table->evaluateAntiderivative(x); }
+
+    public:
+        void setTable(std::shared_ptr<const TabulatedNonlinearity> newTable) { table = std::move(newTable); }
+    };
+
+    /**
+     * @brief Second-order ADAA waveshaper driven by a shared TabulatedNonlinearity.
+     *
+     * Set the table before reset(), which evaluates the antiderivatives at 0.
+     */
+    template <typename T>
+    class TabulatedADAA2 : public ADAA2static<TabulatedADAA2<T>, T>
+    {
+        friend class ADAA2static<TabulatedADAA2<T>, T>;
+
+        std::shared_ptr<const TabulatedNonlinearity> table;
+
+        inline T nonlinearity (T x) const noexcept { return table->evaluate(x); }
+        inline T nonlinearityAntiderivative (T x) const noexcept { return table->evaluateAntiderivative(x); }
+        inline T nonlinearityAntiderivative2 (T x) const noexcept { return table->evaluateAntiderivative2(x); }
+
+    public:
+        void setTable(std::shared_ptr<const TabulatedNonlinearity> newTable) { table = std::move(newTable); }
+    };
+}
@@ -1,5 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+#include "Simd.h"
+
 namespace Ath::Math 
 {
     template<typename T>
@@ -8,22 +15,21 @@ namespace Ath::Math
         T re = 0.0f;
         T im = 0.0f;
 
-        complex<T>(T r = 0.0f, T i = 0.0f) : re(r), im(i) {}
-        complex<T>(const complex<T>&) = default;
-        complex<T>(T x) : re(x), im(0.0f) {}
+        constexpr complex(T r = 0.0f, T i = 0.0f) : re(r), im(i) {}
+        constexpr complex(const complex<T>&) = default;
 
-        complex<T>& operator=(const complex<T> rhs) { re = rhs.re; im = rhs.im; return *this; };
+        constexpr complex<T>& operator=(const complex<T>&) = default;
 
         // Complex-Complex operations
-        inline complex<T> operator + (const complex<T>& rhs) const noexcept { 
+        constexpr complex<T> operator + (const complex<T>& rhs) const noexcept { 
             return { re + rhs.re, im + rhs.im}; 
         }
         
-        inline complex<T> operator - (const complex<T>& rhs) const noexcept { 
+        constexpr complex<T> operator - (const complex<T>& rhs) const noexcept { 
             return { re - rhs.re, im - rhs.im}; 
         }
         
-        inline complex<T> operator * (const complex<T>& rhs) const noexcept 
+        constexpr complex<T> operator * (const complex<T>& rhs) const noexcept 
         {
             return { 
                 re * rhs.re - im * rhs.im, 
@@ -31,7 +37,7 @@ namespace Ath::Math
             };
         }
         
-        inline complex<T> operator/(const complex<T>& rhs) const noexcept 
+        constexpr complex<T> operator/(const complex<T>& rhs) const noexcept 
         {
             T denom = rhs.re * rhs.re + rhs.im * rhs.im;
             return 
@@ -42,36 +48,36 @@ namespace Ath::Math
         }
 
         // Complex-Scalar operations
-        inline complex<T> operator + (T rhs) const noexcept { 
+        constexpr complex<T> operator + (T rhs) const noexcept { 
             return { re + rhs, im }; 
         }
         
-        inline complex<T> operator - (T rhs) const noexcept { 
+        constexpr complex<T> operator - (T rhs) const noexcept { 
             return { re - rhs, im }; 
         }
         
-        inline complex<T> operator * (T rhs) const noexcept { 
+        constexpr complex<T> operator * (T rhs) const noexcept { 
             return { re * rhs, im * rhs }; 
         }
         
-        inline complex<T> operator / (T rhs) const noexcept { 
+        constexpr complex<T> operator / (T rhs) const noexcept { 
             return { re / rhs, im / rhs }; 
         }
 
         // Scalar-Complex operations (as friend functions)
-        friend inline complex<T> operator + (T lhs, const complex<T>& rhs) noexcept { 
+        friend constexpr complex<T> operator + (T lhs, const complex<T>& rhs) noexcept { 
             return { lhs + rhs.re, rhs.im }; 
         }
         
-        friend inline complex<T> operator - (T lhs, const complex<T>& rhs) noexcept { 
+        friend constexpr complex<T> operator - (T lhs, const complex<T>& rhs) noexcept { 
             return { lhs - rhs.re, -rhs.im }; 
         }
         
-        friend inline complex<T> operator * (T lhs, const complex<T>& rhs) noexcept { 
+        friend constexpr complex<T> operator * (T lhs, const complex<T>& rhs) noexcept { 
             return { lhs * rhs.re, lhs * rhs.im }; 
         }
         
-        friend inline complex<T> operator / (T lhs, const complex<T>& rhs) noexcept { 
+        friend constexpr complex<T> operator / (T lhs, const complex<T>& rhs) noexcept { 
             T denom = rhs.re * rhs.re + rhs.im * rhs.im;
             return 
             {
@@ -81,71 +87,257 @@ namespace Ath::Math
         }
 
         // Compound assignment operators for complex
-        inline complex<T>& operator += (const complex<T>& rhs) noexcept { 
+        constexpr complex<T>& operator += (const complex<T>& rhs) noexcept { 
             re += rhs.re; im += rhs.im; return *this; 
         }
         
-        inline complex<T>& operator -= (const complex<T>& rhs) noexcept { 
+        constexpr complex<T>& operator -= (const complex<T>& rhs) noexcept { 
             re -= rhs.re; im -= rhs.im; return *this; 
         }
         
-        inline complex<T>& operator *= (const complex<T>& rhs) noexcept { 
+        constexpr complex<T>& operator *= (const complex<T>& rhs) noexcept { 
             *this = *this * rhs; return *this; 
         }
         
-        inline complex<T>& operator /= (const complex<T>& rhs) noexcept { 
+        constexpr complex<T>& operator /= (const complex<T>& rhs) noexcept { 
             *this = *this / rhs; return *this; 
         }
 
         // Compound assignment operators for scalars
-        inline complex<T>& operator += (T rhs) noexcept { 
+        constexpr complex<T>& operator += (T rhs) noexcept { 
             re += rhs; return *this; 
         }
         
-        inline complex<T>& operator -= (T rhs) noexcept { 
+        constexpr complex<T>& operator -= (T rhs) noexcept { 
             re -= rhs; return *this; 
         }
         
-        inline complex<T>& operator *= (T rhs) noexcept { 
+        constexpr complex<T>& operator *= (T rhs) noexcept { 
             re *= rhs; im *= rhs; return *this; 
         }
         
-        inline complex<T>& operator /= (T rhs) noexcept { 
+        constexpr complex<T>& operator /= (T rhs) noexcept { 
             re /= rhs; im /= rhs; return *this; 
         }
 
         // Unary operators
-        inline complex<T> operator + () const noexcept { 
+        constexpr complex<T> operator + () const noexcept { 
             return *this; 
         }
         
-        inline complex<T> operator - () const noexcept { 
+        constexpr complex<T> operator - () const noexcept { 
             return { -re, -im }; 
         }
 
         // Comparison operators (optional but useful)
-        inline bool operator == (const complex<T>& rhs) const noexcept { 
+        constexpr bool operator == (const complex<T>& rhs) const noexcept { 
             return re == rhs.re && im == rhs.im; 
         }
         
-        inline bool operator != (const complex<T>& rhs) const noexcept { 
+        constexpr bool operator != (const complex<T>& rhs) const noexcept { 
             return !(*this == rhs); 
         }
         
-        inline bool operator == (T rhs) const noexcept { 
+        constexpr bool operator == (T rhs) const noexcept { 
             return re == rhs && im == T(0); 
         }
         
-        inline bool operator != (T rhs) const noexcept { 
+        constexpr bool operator != (T rhs) const noexcept { 
             return !(*this == rhs); 
         }
         
-        friend inline bool operator == (T lhs, const complex<T>& rhs) noexcept { 
+        friend constexpr bool operator == (T lhs, const complex<T>& rhs) noexcept { 
             return rhs == lhs; 
         }
         
-        friend inline bool operator != (T lhs, const complex<T>& rhs) noexcept { 
+        friend constexpr bool operator != (T lhs, const complex<T>& rhs) noexcept { 
             return rhs != lhs; 
         }
     };
+
+    /**
+     * @brief Complex number with one SIMD vector per part, e.g. complexN<Simd::float8> holds 8 values.
+     *
+     * The same arithmetic as complex<T>, lane by lane; see ComplexBuffer for
+     * arrays of them.
+     */
+    template<typename V>
+    using complexN = complex<V>;
+
+    template<typename T>
+    constexpr complex<T> conj(const complex<T>& z) noexcept { return { z.re, -z.im }; }
+
+    /** @return |z|^2 */
+    template<typename T>
+    constexpr T norm(const complex<T>& z) noexcept { return z.re * z.re + z.im * z.im; }
+
+    template<typename T>
+    inline T abs(const complex<T>& z) noexcept
+    {
+        if constexpr (std::is_floating_point_v<T>) return std::sqrt(norm(z));
+        else return Simd::sqrt(norm(z));
+    }
+
+    /**
+     * @return Phase in [-pi, pi]; via Simd::fastAtan2 for vector types
+     */
+    template<typename T>
+    inline T arg(const complex<T>& z) noexcept
+    {
+        if constexpr (std::is_floating_point_v<T>) return std::atan2(z.im, z.re);
+        else return Simd::fastAtan2(z.im, z.re);
+    }
+
+    /**
+     * @brief Split (SoA) array of complex values: all real parts, then all imaginary parts.
+     *
+     * Both parts are vector-aligned and padded with zeros to a whole number of
+     * vectors, so element-wise operations run over complexN values without a
+     * scalar tail. real() and imag() are what Fft::forwardReal and
+     * inverseReal take. Operands must have the same size.
+     */
+    class ComplexBuffer
+    {
+    public:
+    #if SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX2
+        using Vector = Simd::float8;
+    #else
+        using Vector = Simd::float4;
+    #endif
+
+        static constexpr int vectorSize = Vector::VectorSize;
+
+    private:
+        std::vector<Vector> re;
+        std::vector<Vector> im;
+        int size = 0;
+
+        // Vector results to n floats, without writing past them
+        template<typename F>
+        void store(float* out, F&& compute) const
+        {
+            const int full = size / vectorSize;
+
+            for (int v = 0; v < full; v++) compute(v).storeUnaligned(out + v * vectorSize);
+
+            if (const int tail = size - full * vectorSize; tail > 0)
+            {
+                alignas(64) float last[vectorSize];
+                compute(full).storeUnaligned(last);
+                std::copy(last, last + tail, out + full * vectorSize);
+            }
+        }
+
+    public:
+        ComplexBuffer() = default;
+
+        explicit ComplexBuffer(int numberOfValues) { resize(numberOfValues); }
+
+        /**
+         * @brief Set the number of values. Allocates if it grows; every value, and the padding, is zero afterwards.
+         */
+        void resize(int numberOfValues)
+        {
+            size = std::max(numberOfValues, 0);
+
+            const int numberOfVectors = (size + vectorSize - 1) / vectorSize;
+            re.assign(numberOfVectors, Vector(0.0f));
+            im.assign(numberOfVectors, Vector(0.0f));
+        }
+
+        int getSize() const { return size; }
+
+        int getNumberOfVectors() const { return static_cast<int>(re.size()); }
+
+        float* real() { return reinterpret_cast<float*>(re.data()); }
+        float* imag() { return reinterpret_cast<float*>(im.data()); }
+        const float* real() const { return reinterpret_cast<const float*>(re.data()); }
+        const float* imag() const { return reinterpret_cast<const float*>(im.data()); }
+
+        void clear()
+        {
+            std::fill(re.begin(), re.end(), Vector(0.0f));
+            std::fill(im.begin(), im.end(), Vector(0.0f));
+        }
+
+        complexN<Vector> getVector(int v) const { return { re[v], im[v] }; }
+
+        void setVector(int v, const complexN<Vector>& z) { re[v] = z.re; im[v] = z.im; }
+
+        /**
+         * @brief Read getSize() values from interleaved re, im pairs (the layout of complex<float> arrays).
+         */
+        void fromInterleaved(const float* in)
+        {
+            float* r = real();
+            float* i = imag();
+
+            for (int k = 0; k < size; k++)
+            {
+                r[k] = in[2 * k];
+                i[k] = in[2 * k + 1];
+            }
+        }
+
+        /**
+         * @brief Write getSize() values as interleaved re, im pairs.
+         */
+        void toInterleaved(float* out) const
+        {
+            const float* r = real();
+            const float* i = imag();
+
+            for (int k = 0; k < size; k++)
+            {
+                out[2 * k] = r[k];
+                out[2 * k + 1] = i[k];
+            }
+        }
+
+        /** @brief this = a * b */
+        void multiply(const ComplexBuffer& a, const ComplexBuffer& b)
+        {
+            for (int v = 0; v < getNumberOfVectors(); v++) setVector(v, a.getVector(v) * b.getVector(v));
+        }
+
+        /** @brief this += a * b, the inner loop of spectral convolution */
+        void multiplyAccumulate(const ComplexBuffer& a, const ComplexBuffer& b)
+        {
+            for (int v = 0; v < getNumberOfVectors(); v++)
+            {
+                const Vector ar = a.re[v], ai = a.im[v];
+                const Vector br = b.re[v], bi = b.im[v];
+
+                re[v] = Simd::fma(ar, br, re[v] - ai * bi);
+                im[v] = Simd::fma(ar, bi, im[v] + ai * br);
+            }
+        }
+
+        /** @brief this = a / b. Division by zero is not guarded, and the zero padding divides to NaN. */
+        void divide(const ComplexBuffer& a, const ComplexBuffer& b)
+        {
+            for (int v = 0; v < getNumberOfVectors(); v++) setVector(v, a.getVector(v) / b.getVector(v));
+        }
+
+        /** @brief this *= a */
+        void multiply(const ComplexBuffer& a) { multiply(*this, a); }
+
+        /** @brief Write |z| of every value to out, getSize() floats. */
+        void magnitude(float* out) const
+        {
+            store(out, [this](int v) { return abs(getVector(v)); });
+        }
+
+        /** @brief Write |z|^2 of every value to out, getSize() floats. */
+        void power(float* out) const
+        {
+            store(out, [this](int v) { return norm(getVector(v)); });
+        }
+
+        /** @brief Write arg(z) of every value to out, getSize() floats; accuracy of Simd::fastAtan2. */
+        void phase(float* out) const
+        {
+            store(out, [this](int v) { return arg(getVector(v)); });
+        }
+    };
 }
\ No newline at end of file
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+namespace Ath::Math
+{
+    /**
+     * @brief Radix-2 FFT on split (SoA) real/imaginary arrays.
+     *
+     * Twiddles, bit-reversal table and scratch memory are allocated by setSize(),
+     * transforms themselves never allocate.
+     */
+    class Fft
+    {
+        int size = 0;                   // real transform size N
+        int half = 0;                   // complex transform size M = N / 2
+
+        std::vector<int> bitReversal;   // size M
+        std::vector<float> twiddleRe;   // e^(-2πik/M), k < M/2
+        std::vector<float> twiddleIm;
+        std::vector<float> realTwiddleRe; // e^(-2πik/N), k <= M
+        std::vector<float> realTwiddleIm;
+
+        std::vector<float> scratchRe;
+        std::vector<float> scratchIm;
+
+        void complexTransform(float* re, float* im, bool inverse) const
+        {
+            const int m = half;
+
+            for (int i = 0; i < m; i++)
+            {
+                const int j = bitReversal[i];
+                if (j > i)
+                {
+                    std::swap(re[i], re[j]);
+                    std::swap(im[i], im[j]);
+                }
+            }
+
+            const float sign = inverse ? -1.0f : 1.0f;
+
+            for (int len = 2; len <= m; len *= 2)
+            {
+                const int h = len / 2;
+                const int step = m / len;
+
+                for (int i = 0; i < m; i += len)
+                {
+                    for (int j = 0; j < h; j++)
+                    {
+                        const float wr = twiddleRe[j * step];
+                        const float wi = twiddleIm[j * step] * sign;
+
+                        const int a = i + j;
+                        const int b = a + h;
+
+                        const float vr = re[b] * wr - im[b] * wi;
+                        const float vi = re[b] * wi + im[b] * wr;
+
+                        re[b] = re[a] - vr;
+                        im[b] = im[a] - vi;
+                        re[a] += vr;
+                        im[a] += vi;
+                    }
+                }
+            }
+        }
+
+    public:
+        /**
+         * @brief Prepare a real transform of size n.
+         *
+         * @param n Transform size, power of two, at least 4
+         */
+        void setSize(int n)
+        {
+            size = n;
+            half = n / 2;
+
+            int bits = 0;
+            while ((1 << bits) < half) bits++;
+
+            bitReversal.resize(half);
+            for (int i = 0; i < half; i++)
+            {
+                int r = 0;
+                for (int b = 0; b < bits; b++) r |= ((i >> b) & 1) << (bits - 1 - b);
+                bitReversal[i] = r;
+            }
+
+            twiddleRe.resize(half / 2 + 1);
+            twiddleIm.resize(half / 2 + 1);
+            for (int k = 0; k <= half / 2; k++)
+            {
+                const double w = -2.0 * std::numbers::pi * double(k) / double(half);
+                twiddleRe[k] = float(std::cos(w));
+                twiddleIm[k] = float(std::sin(w));
+            }
+
+            realTwiddleRe.resize(half + 1);
+            realTwiddleIm.resize(half + 1);
+            for (int k = 0; k <= half; k++)
+            {
+                const double w = -2.0 * std::numbers::pi * double(k) / double(size);
+                realTwiddleRe[k] = float(std::cos(w));
+                realTwiddleIm[k] = float(std::sin(w));
+            }
+
+            scratchRe.resize(half);
+            scratchIm.resize(half);
+        }
+
+        int getSize() const { return size; }
+
+        /** Number of bins produced by forwardReal(): N / 2 + 1 */
+        int getNumberOfBins() const { return half + 1; }
+
+        /**
+         * @brief Forward transform of n real samples into n/2 + 1 complex bins.
+         */
+        void forwardReal(const float* x, float* re, float* im)
+        {
+            float* zr = scratchRe.data();
+            float* zi = scratchIm.data();
+
+            // Pack even/odd samples into one half-size complex sequence
+            for (int m = 0; m < half; m++)
+            {
+                zr[m] = x[2 * m];
+                zi[m] = x[2 * m + 1];
+            }
+
+            complexTransform(zr, zi, false);
+
+            for (int k = 0; k <= half; k++)
+            {
+                const int k1 = k == half ? 0 : k;
+                const int k2 = k == 0 ? 0 : half - k;
+
+                // E = (Z[k] + conj(Z[M-k])) / 2, O = (Z[k] - conj(Z[M-k])) / 2i
+                const float er = 0.5f * (zr[k1] + zr[k2]);
+                const float ei = 0.5f * (zi[k1] - zi[k2]);
+                const float or_ = 0.5f * (zi[k1] + zi[k2]);
+                const float oi = -0.5f * (zr[k1] - zr[k2]);
+
+                const float wr = realTwiddleRe[k];
+                const float wi = realTwiddleIm[k];
+
+                re[k] = er + or_ * wr - oi * wi;
+                im[k] = ei + or_ * wi + oi * wr;
+            }
+        }
+
+        /**
+         * @brief Inverse of forwardReal(), including the 1/n normalization.
+         */
+        void inverseReal(const float* re, const float* im, float* x)
+        {
+            float* zr = scratchRe.data();
+            float* zi = scratchIm.data();
+
+            for (int k = 0; k < half; k++)
+            {
+                const int k2 = half - k;
+
+                // E = (X[k] + conj(X[M-k])) / 2, O = (X[k] - conj(X[M-k])) / 2 * e^(2πik/N)
+                const float er = 0.5f * (re[k] + re[k2]);
+                const float ei = 0.5f * (im[k] - im[k2]);
+                const float dr = 0.5f * (re[k] - re[k2]);
+                const float di = 0.5f * (im[k] + im[k2]);
+
+                const float wr = realTwiddleRe[k];
+                const float wi = -realTwiddleIm[k];
+
+                const float or_ = dr * wr - di * wi;
+                const float oi = dr * wi + di * wr;
+
+                // Z = E + iO
+                zr[k] = er - oi;
+                zi[k] = ei + or_;
+            }
+
+            complexTransform(zr, zi, true);
+
+            const float scale = 1.0f / float(half);
+            for (int m = 0; m < half; m++)
+            {
+                x[2 * m] = zr[m] * scale;
+                x[2 * m + 1] = zi[m] * scale;
+            }
+        }
+    };
+}
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <bit>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
+#include <limits>
 #include <numbers>
+#include <type_traits>
 
 namespace Ath::Math
 {
@@ -265,6 +269,65 @@ namespace Ath::Math
         return a * std::pow(T(10), log * x);
     }
 
+    // ============================================================
+    // EXPONENTIALS AND LOGARITHMS
+    // ============================================================
+
+    /**
+     * @brief Fast 2^x approximation.
+     *
+     * Splits x into a nearest integer k and a remainder f in [-0.5, 0.5],
+     * evaluates 2^f with a 6th-order polynomial and adds k to the exponent bits.
+     * Max measured relative error: ~1e-7. Input is clamped to [-126, 126].
+     * Simd.h provides the same routine for float4 / float8.
+     */
+    static inline float fastExp2(float x) noexcept
+    {
+        x = min(max(x, -126.0f), 126.0f);
+
+        // x + 127.5 > 0, so truncation rounds x to nearest
+        const int k = static_cast<int>(x + 127.5f) - 127;
+        const float f = x - static_cast<float>(k);
+
+        float p = 1.535336188319500e-4f;
+        p = p * f + 1.339887440266574e-3f;
+        p = p * f + 9.618437357674640e-3f;
+        p = p * f + 5.550332471162809e-2f;
+        p = p * f + 2.402264791363012e-1f;
+        p = p * f + 6.931472028550421e-1f;
+        p = p * f + 1.0f;
+
+        return p * std::bit_cast<float>(static_cast<std::int32_t>((k + 127) << 23));
+    }
+
+    /**
+     * @brief Fast log2(x) approximation for positive, normal x.
+     *
+     * Takes the exponent from the float bits and the mantissa m in [sqrt(0.5), sqrt(2)),
+     * then evaluates log2(m) as an atanh series in t = (m - 1) / (m + 1).
+     * Max measured absolute error: ~2e-7.
+     * Simd.h provides the same routine for float4 / float8.
+     */
+    static inline float fastLog2(float x) noexcept
+    {
+        const std::int32_t bits = std::bit_cast<std::int32_t>(x);
+
+        float e = static_cast<float>(((bits >> 23) & 0xFF) - 127);
+        float m = std::bit_cast<float>((bits & 0x7FFFFF) | 0x3F800000);
+
+        if (m > std::numbers::sqrt2_v<float>)
+        {
+            m *= 0.5f;
+            e += 1.0f;
+        }
+
+        const float t = (m - 1.0f) / (m + 1.0f);
+        const float t2 = t * t;
+
+        // 2/ln(2) * (t + t^3/3 + t^5/5 + t^7/7)
+        return e + t * (2.885390081777927f + t2 * (0.961796693925976f + t2 * (0.577078016355585f + t2 * 0.412198583111132f)));
+    }
+
     // ============================================================
     // TRIGONOMETRY
     // ============================================================
@@ -359,7 +422,7 @@ namespace Ath::Math
         T q0 = 0.23511073607542215536;
         T q2 = 0.18027037928061467875;
         T q4 = 0.06847091023266492493;
-        T q6 = 3.96825138090984630423;
+        T q6 = 0.01599777450637567000;
         T q8 = 0.00209141397521427812;
 
         auto x2 = x * x;
@@ -379,7 +442,7 @@ namespace Ath::Math
         T q0 = 0.23511073607542215536;
         T q2 = 0.18027037928061467875;
         T q4 = 0.06847091023266492493;
-        T q6 = 3.96825138090984630423;
+        T q6 = 0.01599777450637567000;
         T q8 = 0.00209141397521427812;
 
         x -= 0.5;
@@ -580,6 +643,33 @@ namespace Ath::Math
         return std::pow(T(2), semitones / T(12));
     }
 
+    /**
+     * @brief MIDI note number to frequency via fastExp2. Works with float and SIMD types.
+     */
+    template <typename T>
+    static inline T fastNoteToFrequency (T p, T referenceFrequency = T(440.0f))
+    {
+        return referenceFrequency * fastExp2((p - T(float(A4_MIDI_NOTE_NUMBER))) * T(1.0f / 12.0f));
+    }
+
+    /**
+     * @brief Frequency to MIDI note number via fastLog2. Works with float and SIMD types.
+     */
+    template <typename T>
+    static inline T fastFrequencyToNote (T freq, T referenceFrequency = T(440.0f))
+    {
+        return T(float(A4_MIDI_NOTE_NUMBER)) + T(12.0f) * fastLog2(freq / referenceFrequency);
+    }
+
+    /**
+     * @brief Semitones to frequency ratio via fastExp2. Works with float and SIMD types.
+     */
+    template <typename T>
+    static inline T fastSemitonesToFrequencyRatio (T semitones)
+    {
+        return fastExp2(semitones * T(1.0f / 12.0f));
+    }
+
     // ============================================================
     // dB CONSTANTS
     // ============================================================
@@ -654,6 +744,26 @@ namespace Ath::Math
         return std::pow(T(10), db / T(10));
     }
 
+    /**
+     * @brief Amplitude to dB via fastLog2. Works with float and SIMD types.
+     */
+    template <typename T>
+    static inline T fastAmplitudeToDecibels (T gain)
+    {
+        // 20 * log10(2)
+        return T(6.020599913279624f) * fastLog2(gain);
+    }
+
+    /**
+     * @brief dB to amplitude via fastExp2. Works with float and SIMD types.
+     */
+    template <typename T>
+    static inline T fastDecibelsToAmplitude (T db)
+    {
+        // log2(10) / 20
+        return fastExp2(db * T(0.166096404744368f));
+    }
+
     /**
      * @brief Linear slider mapped to logarithmic amplitude.
      *
@@ -666,5 +776,90 @@ namespace Ath::Math
         const T dB = std::lerp(dB_at0, T(0), x);
         return decibelsToAmplitude(dB);
     }
-    
+
+    // ============================================================
+    // CONSTEXPR FUNCTIONS
+    // ============================================================
+
+    /**
+     * Double-precision sin, cos, tan, sqrt and exp that can run at compile
+     * time, for coefficient design in constant expressions. At run time they
+     * call the std functions; at compile time they use series accurate to a
+     * few ulp over the ranges filter design needs.
+     */
+    namespace Constexpr
+    {
+        constexpr double sqrt(double x)
+        {
+            if (!std::is_constant_evaluated()) return std::sqrt(x);
+            if (!(x > 0.0)) return x == 0.0 ? 0.0 : std::numeric_limits<double>::quiet_NaN();
+
+            // Newton from above converges monotonically, stop when it stops decreasing
+            double y = x > 1.0 ? x : 1.0;
+            while (true)
+            {
+                const double next = 0.5 * (y + x / y);
+                if (next >= y) return y;
+                y = next;
+            }
+        }
+
+        constexpr double sin(double x)
+        {
+            if (!std::is_constant_evaluated()) return std::sin(x);
+
+            // Reduce to [-pi, pi]
+            const double turns = x * std::numbers::inv_pi * 0.5;
+            const auto whole = static_cast<long long>(turns + (turns >= 0.0 ? 0.5 : -0.5));
+            x -= static_cast<double>(whole) * 2.0 * std::numbers::pi;
+
+            double term = x, sum = x;
+            for (int n = 1; n < 30; n++)
+            {
+                term *= -x * x / double((2 * n) * (2 * n + 1));
+                sum += term;
+            }
+            return sum;
+        }
+
+        constexpr double cos(double x)
+        {
+            if (!std::is_constant_evaluated()) return std::cos(x);
+            return sin(x + std::numbers::pi * 0.5);
+        }
+
+        constexpr double tan(double x)
+        {
+            if (!std::is_constant_evaluated()) return std::tan(x);
+            return sin(x) / cos(x);
+        }
+
+        constexpr double exp(double x)
+        {
+            if (!std::is_constant_evaluated()) return std::exp(x);
+
+            // x = n ln2 + r with |r| <= ln2 / 2
+            const double scaled = x / std::numbers::ln2;
+            const auto n = static_cast<long long>(scaled + (scaled >= 0.0 ? 0.5 : -0.5));
+            const double r = x - static_cast<double>(n) * std::numbers::ln2;
+
+            double term = 1.0, sum = 1.0;
+            for (int k = 1; k < 25; k++)
+            {
+                term *= r / double(k);
+                sum += term;
+            }
+
+            for (long long i = 0; i < n; i++) sum *= 2.0;
+            for (long long i = 0; i > n; i--) sum *= 0.5;
+            return sum;
+        }
+
+        /// 10^x
+        constexpr double pow10(double x)
+        {
+            if (!std::is_constant_evaluated()) return std::pow(10.0, x);
+            return exp(x * std::numbers::ln10);
+        }
+    }
 }
@@ -0,0 +1,71 @@
+#include <initializer_list>
+
+#include "MathBulk.h"
+#include "Math.h"
+
+namespace Ath::Math::Bulk
+{
+    // Defined in bulk/MathBulk<Isa>.cpp, each compiled with its own ISA flags.
+    // They return nullptr when built for an architecture they do not target.
+    const Kernels* getSse2Kernels() noexcept;
+    const Kernels* getAvx2Kernels() noexcept;
+    const Kernels* getAvx512Kernels() noexcept;
+    const Kernels* getNeonKernels() noexcept;
+
+    namespace
+    {
+        // Plain loops over the scalar approximations, for targets without SIMD support
+        template <float (*F)(float)>
+        void scalarLoop(const float* in, float* out, int n) noexcept
+        {
+            for (int i = 0; i < n; i++) out[i] = F(in[i]);
+        }
+
+        template <float (*F)(float, float)>
+        void scalarLoop(const float* in, float* out, int n, float reference) noexcept
+        {
+            for (int i = 0; i < n; i++) out[i] = F(in[i], reference);
+        }
+
+        const Kernels scalarKernels
+        {
+            Simd::Isa::Scalar,
+            &scalarLoop<Math::sin2pi5<float>>, &scalarLoop<Math::sin2pi7<float>>,
+            &scalarLoop<Math::sin2pi9<float>>, &scalarLoop<Math::fastTan<float>>,
+            &scalarLoop<Math::fastExp2>, &scalarLoop<Math::fastLog2>,
+            &scalarLoop<Math::fastNoteToFrequency<float>>, &scalarLoop<Math::fastFrequencyToNote<float>>,
+            &scalarLoop<Math::fastSemitonesToFrequencyRatio<float>>,
+            &scalarLoop<Math::fastDecibelsToAmplitude<float>>, &scalarLoop<Math::fastAmplitudeToDecibels<float>>
+        };
+    }
+
+    const Kernels* getKernels(Simd::Isa isa) noexcept
+    {
+        if (!Simd::isSupported(isa)) return nullptr;
+
+        switch (isa)
+        {
+            case Simd::Isa::Scalar: return &scalarKernels;
+            case Simd::Isa::SSE2: return getSse2Kernels();
+            case Simd::Isa::AVX2: return getAvx2Kernels();
+            case Simd::Isa::AVX512: return getAvx512Kernels();
+            case Simd::Isa::NEON: return getNeonKernels();
+        }
+        return nullptr;
+    }
+
+    const Kernels& getKernels() noexcept
+    {
+        static const Kernels& selected = []() -> const Kernels&
+        {
+            // Widest first; an ISA the library was built without falls through to the next one
+            for (const auto isa : { Simd::Isa::NEON, Simd::Isa::AVX512, Simd::Isa::AVX2, Simd::Isa::SSE2 })
+            {
+                if (const Kernels* kernels = getKernels(isa)) return *kernels;
+            }
+            return scalarKernels;
+        }();
+
+        return selected;
+    }
+}
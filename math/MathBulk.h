@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <span>
+
+#include "SimdDispatch.h"
+
+namespace Ath::Math::Bulk
+{
+    /**
+     * Span versions of the scalar approximations in Math.h.
+     *
+     * Each call runs the scalar template instantiated for a SIMD vector type
+     * over the whole span. A partial last vector is padded in an aligned scratch
+     * vector, so any length is valid and nothing is read or written past the end.
+     * Input and output may be the same span. Unaligned spans are fine; 64-byte
+     * aligned ones avoid split loads.
+     *
+     * The kernels are compiled once per instruction set (bulk/MathBulk<Isa>.cpp)
+     * and the widest one the CPU supports is picked on first use, so this header
+     * needs no ISA flags and the library runs on any CPU of its architecture.
+     *
+     * These live in their own namespace so that two-argument calls never
+     * compete with the (T value, T reference) templates in Ath::Math.
+     */
+
+    /// Table of kernels compiled for one instruction set
+    struct Kernels
+    {
+        using Function = void (*)(const float* in, float* out, int n);
+        using ReferenceFunction = void (*)(const float* in, float* out, int n, float reference);
+
+        Simd::Isa isa;
+
+        Function sin2pi5;
+        Function sin2pi7;
+        Function sin2pi9;
+        Function fastTan;
+
+        Function exp2;
+        Function log2;
+
+        ReferenceFunction noteToFrequency;
+        ReferenceFunction frequencyToNote;
+        Function semitonesToFrequencyRatio;
+        Function decibelsToAmplitude;
+        Function amplitudeToDecibels;
+    };
+
+    /**
+     * @brief Kernels for the widest instruction set this CPU supports. Selected once.
+     */
+    const Kernels& getKernels() noexcept;
+
+    /**
+     * @brief Kernels for a given instruction set, e.g. to compare them in benchmarks.
+     *
+     * @return nullptr if they were not compiled in or the CPU does not support them
+     */
+    const Kernels* getKernels(Simd::Isa isa) noexcept;
+
+    static inline int length(std::span<const float> in, std::span<float> out) noexcept
+    {
+        return static_cast<int>(std::min(in.size(), out.size()));
+    }
+
+    // ============================================================
+    // TRIGONOMETRY
+    // ============================================================
+
+    /// sin(2pi * x), 5th-order polynomial. See Math::sin2pi5.
+    static inline void sin2pi5(std::span<const float> in, std::span<float> out) noexcept
+    {
+        getKernels().sin2pi5(in.data(), out.data(), length(in, out));
+    }
+
+    /// sin(2pi * x), 7th-order polynomial. See Math::sin2pi7.
+    static inline void sin2pi7(std::span<const float> in, std::span<float> out) noexcept
+    {
+        getKernels().sin2pi7(in.data(), out.data(), length(in, out));
+    }
+
+    /// sin(2pi * x) for [-0.5, 0.5] input, rational approximation. See Math::sin2pi9.
+    static inline void sin2pi9(std::span<const float> in, std::span<float> out) noexcept
+    {
+        getKernels().sin2pi9(in.data(), out.data(), length(in, out));
+    }
+
+    /// tan(x), Pade approximation. See Math::fastTan.
+    static inline void fastTan(std::span<const float> in, std::span<float> out) noexcept
+    {
+        getKernels().fastTan(in.data(), out.data(), length(in, out));
+    }
+
+    // ============================================================
+    // EXPONENTIALS AND LOGARITHMS
+    // ============================================================
+
+    /// 2^x. See Math::fastExp2.
+    static inline void exp2(std::span<const float> in, std::span<float> out) noexcept
+    {
+        getKernels().exp2(in.data(), out.data(), length(in, out));
+    }
+
+    /// log2(x) for positive x. See Math::fastLog2.
+    static inline void log2(std::span<const float> in, std::span<float> out) noexcept
+    {
+        getKernels().log2(in.data(), out.data(), length(in, out));
+    }
+
+    // ============================================================
+    // NOTE / FREQUENCY AND dB CONVERSIONS
+    // ============================================================
+
+    /// MIDI note numbers (fractional allowed) to frequencies
+    static inline void noteToFrequency(std::span<const float> in, std::span<float> out, float referenceFrequency = 440.0f) noexcept
+    {
+        getKernels().noteToFrequency(in.data(), out.data(), length(in, out), referenceFrequency);
+    }
+
+    /// Frequencies to MIDI note numbers
+    static inline void frequencyToNote(std::span<const float> in, std::span<float> out, float referenceFrequency = 440.0f) noexcept
+    {
+        getKernels().frequencyToNote(in.data(), out.data(), length(in, out), referenceFrequency);
+    }
+
+    static inline void semitonesToFrequencyRatio(std::span<const float> in, std::span<float> out) noexcept
+    {
+        getKernels().semitonesToFrequencyRatio(in.data(), out.data(), length(in, out));
+    }
+
+    static inline void decibelsToAmplitude(std::span<const float> in, std::span<float> out) noexcept
+    {
+        getKernels().decibelsToAmplitude(in.data(), out.data(), length(in, out));
+    }
+
+    static inline void amplitudeToDecibels(std::span<const float> in, std::span<float> out) noexcept
+    {
+        getKernels().amplitudeToDecibels(in.data(), out.data(), length(in, out));
+    }
+}
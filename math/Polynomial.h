@@ -13,7 +13,7 @@ namespace Ath::Math
         {
             T y = coefficients[0];
 
-            for (int i = 0; i < N; i++)
+            for (int i = 1; i < N; i++)
             {
                 y = y * x + coefficients[i];
             }
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "Math.h"
+#include "Simd.h"
+
+namespace Ath::Math::Random
+{
+    /**
+     * @brief Counter-based random generator producing a SIMD vector of values per step.
+     *
+     * The value at position p is a hash of p and the stream key, so there is
+     * no sequential state: seek() jumps anywhere in O(1) and split() derives an
+     * independent stream, e.g. one per voice, that reproduces the same values
+     * for the same seed and stream index regardless of what other streams do.
+     * Streams have 2^32 values (about 24 hours at 48 kHz) before they repeat.
+     *
+     * The hash is Chris Wellons' lowbias32 integer mixer on the counter
+     * multiplied by an odd constant and xored with the key. It needs 32-bit
+     * lane multiplies and logical shifts only.
+     *
+     * @tparam V SIMD float type, e.g. Simd::float8 or Simd::float16
+     */
+    template <typename V>
+    class CounterBasedGenerator
+    {
+        using I = Simd::intAnalogOf<V>;
+        static constexpr int lanes = V::VectorSize;
+
+        uint32_t key = 0;
+        uint32_t normalKey = 0;
+        uint32_t counter = 0;
+
+        static constexpr uint32_t mix(uint32_t x)
+        {
+            x ^= x >> 16;
+            x *= 0x7feb352du;
+            x ^= x >> 15;
+            x *= 0x846ca68bu;
+            x ^= x >> 16;
+            return x;
+        }
+
+        static inline I mix(I x)
+        {
+            x = x ^ Simd::shiftRightLogical(x, 16);
+            x = x * I(static_cast<int>(0x7feb352du));
+            x = x ^ Simd::shiftRightLogical(x, 15);
+            x = x * I(static_cast<int>(0x846ca68bu));
+            x = x ^ Simd::shiftRightLogical(x, 16);
+            return x;
+        }
+
+        static inline I laneOffsets()
+        {
+            alignas(64) int offsets[lanes];
+            for (int i = 0; i < lanes; i++) offsets[i] = i;
+            return I(offsets);
+        }
+
+        inline I bitsAt(uint32_t position, uint32_t streamKey) const
+        {
+            const I counters = I(static_cast<int>(position)) + laneOffsets();
+            return mix((counters * I(static_cast<int>(0x9e3779b9u))) ^ I(static_cast<int>(streamKey)));
+        }
+
+        // 24 random bits to [0, 1)
+        static inline V toUniform(I bits)
+        {
+            return Simd::toFloat(Simd::shiftRightLogical(bits, 8)) * V(1.0f / 16777216.0f);
+        }
+
+        inline V uniformAt(uint32_t position) const { return toUniform(bitsAt(position, key)); }
+
+        inline V bipolarAt(uint32_t position) const { return uniformAt(position) * V(2.0f) - V(1.0f); }
+
+        // Box-Muller on two independent hashes of the same counter
+        inline V normalAt(uint32_t position) const
+        {
+            const V u1 = toUniform(bitsAt(position, key)) + V(1.0f / 16777216.0f);   // (0, 1]
+            const V u2 = toUniform(bitsAt(position, normalKey)) - V(0.5f);         // [-0.5, 0.5)
+
+            const V radius = Simd::sqrt(V(-2.0f * 0.69314718f) * Simd::fastLog2(u1));
+            return radius * Math::sin2pi9(u2);
+        }
+
+        template <typename F>
+        void fill(std::span<float> out, F valueAt)
+        {
+            const int n = static_cast<int>(out.size());
+            float* data = out.data();
+
+            int i = 0;
+            for (; i + lanes <= n; i += lanes)
+            {
+                valueAt(counter).storeUnaligned(data + i);
+                counter += lanes;
+            }
+
+            if (i < n)
+            {
+                // Values depend only on their position, so a partial vector continues exactly where the next fill starts
+                alignas(64) float tail[lanes];
+                valueAt(counter).store(tail);
+                for (int k = 0; i + k < n; k++) data[i + k] = tail[k];
+                counter += static_cast<uint32_t>(n - i);
+            }
+        }
+
+    public:
+        /**
+         * @param seed Seed shared by a family of streams
+         * @param stream Index of this stream in the family
+         */
+        explicit CounterBasedGenerator(uint32_t seed = 0, uint32_t stream = 0)
+        {
+            key = mix(mix(seed) ^ mix(stream + 0x9e3779b9u));
+            normalKey = mix(key ^ 0x85ebca6bu);
+        }
+
+        /**
+         * @brief Independent stream of the same family, starting at position 0.
+         */
+        CounterBasedGenerator split(uint32_t stream) const
+        {
+            CounterBasedGenerator other;
+            other.key = mix(key ^ mix(stream + 0x9e3779b9u));
+            other.normalKey = mix(other.key ^ 0x85ebca6bu);
+            return other;
+        }
+
+        /**
+         * @brief Jump to a position in the stream, in values.
+         */
+        void seek(uint32_t position) { counter = position; }
+
+        uint32_t getPosition() const { return counter; }
+
+        /// One vector of values in [0, 1)
+        inline V nextUniform() { const V v = uniformAt(counter); counter += lanes; return v; }
+
+        /// One vector of values in [-1, 1)
+        inline V nextBipolar() { const V v = bipolarAt(counter); counter += lanes; return v; }
+
+        /// One vector of standard normal values
+        inline V nextNormal() { const V v = normalAt(counter); counter += lanes; return v; }
+
+        void fillUniform(std::span<float> out) { fill(out, [this](uint32_t p) { return uniformAt(p); }); }
+
+        void fillBipolar(std::span<float> out) { fill(out, [this](uint32_t p) { return bipolarAt(p); }); }
+
+        void fillNormal(std::span<float> out) { fill(out, [this](uint32_t p) { return normalAt(p); }); }
+    };
+}
@@ -2,15 +2,39 @@
 
 /*
     This is a cut-down version of https://github.com/devoln/Simd with (supposedly) improved readability and structure
+
+    The instruction set is taken from the compiler flags of the including translation unit:
+     - x86: int4 / float4 from SSE2, int8 / float8 from AVX2, int16 / float16 from AVX-512F
+     - AArch64: int4 / float4 on NEON
+    Define SIMD_SSE_LEVEL before including to override the x86 level.
+    Code that must run on any x86 CPU should be built for the baseline and call
+    per-ISA kernels through a dispatch table (see SimdDispatch.h).
 */
-#include <immintrin.h>
 #include <type_traits>
-#include <xmmintrin.h>
 
 #if (defined(_M_AMD64) || defined(_M_X64) || defined(__amd64)) && !defined(__x86_64__)
     #define __x86_64__ 1
 #endif
 
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_IX86)
+    #define SIMD_ARCH_X86 1
+    // GCC's AVX-512 intrinsics start from _mm512_undefined_ps(), a self-initialised variable
+    // that -Wmaybe-uninitialized reports at every inlined use
+    #if defined(__GNUC__) && !defined(__clang__)
+        #pragma GCC diagnostic push
+        #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+        #include <immintrin.h>
+        #pragma GCC diagnostic pop
+    #else
+        #include <immintrin.h>
+    #endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #define SIMD_ARCH_NEON 1
+    #include <arm_neon.h>
+#else
+    #error "Simd.h supports x86 (SSE2 and up) and AArch64 (NEON) targets"
+#endif
+
 #define SIMD_SSE_LEVEL_NONE 0
 #define SIMD_SSE_LEVEL_SSE 1
 #define SIMD_SSE_LEVEL_SSE2 2
@@ -20,8 +44,38 @@
 #define SIMD_SSE_LEVEL_SSE4_2 6
 #define SIMD_SSE_LEVEL_AVX 7
 #define SIMD_SSE_LEVEL_AVX2 8
+#define SIMD_SSE_LEVEL_AVX512 9
+
+#ifndef SIMD_SSE_LEVEL
+    #if defined(__AVX512F__)
+        #define SIMD_SSE_LEVEL SIMD_SSE_LEVEL_AVX512
+    #elif defined(__AVX2__)
+        #define SIMD_SSE_LEVEL SIMD_SSE_LEVEL_AVX2
+    #elif defined(__AVX__)
+        #define SIMD_SSE_LEVEL SIMD_SSE_LEVEL_AVX
+    #elif defined(__SSE4_2__)
+        #define SIMD_SSE_LEVEL SIMD_SSE_LEVEL_SSE4_2
+    #elif defined(__SSE4_1__)
+        #define SIMD_SSE_LEVEL SIMD_SSE_LEVEL_SSE4_1
+    #elif defined(__SSSE3__)
+        #define SIMD_SSE_LEVEL SIMD_SSE_LEVEL_SSSE3
+    #elif defined(__SSE3__)
+        #define SIMD_SSE_LEVEL SIMD_SSE_LEVEL_SSE3
+    #elif defined(SIMD_ARCH_X86) && (defined(__SSE2__) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+        #define SIMD_SSE_LEVEL SIMD_SSE_LEVEL_SSE2
+    #else
+        #define SIMD_SSE_LEVEL SIMD_SSE_LEVEL_NONE
+    #endif
+#endif
+
+#if defined(SIMD_ARCH_X86) && SIMD_SSE_LEVEL < SIMD_SSE_LEVEL_SSE2
+    #error "Simd.h requires at least SSE2 on x86"
+#endif
 
-#define SIMD_SSE_LEVEL SIMD_SSE_LEVEL_AVX2
+// MSVC has no __FMA__ macro; /arch:AVX2 implies FMA
+#if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+    #define SIMD_HAS_FMA 1
+#endif
 
 #ifdef _MSC_VER
     #define forceinline __forceinline
@@ -38,9 +92,32 @@
     #define SIMD_VECTORCALL
 #endif
 
+// Every instruction set level gets its own inline namespace. Out-of-line copies of the functions here,
+// built with different flags in different translation units (see math/bulk), then have different
+// mangled names, so the linker cannot merge them even where they are not inlined (e.g. MSVC /Od).
+#if defined(SIMD_ARCH_NEON)
+    #define SIMD_ISA_NAMESPACE neon
+#elif SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX512 && defined(SIMD_HAS_FMA)
+    #define SIMD_ISA_NAMESPACE avx512_fma
+#elif SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX512
+    #define SIMD_ISA_NAMESPACE avx512
+#elif SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX2 && defined(SIMD_HAS_FMA)
+    #define SIMD_ISA_NAMESPACE avx2_fma
+#elif SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX2
+    #define SIMD_ISA_NAMESPACE avx2
+#elif SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX
+    #define SIMD_ISA_NAMESPACE avx
+#elif SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_SSE4_1
+    #define SIMD_ISA_NAMESPACE sse4_1
+#else
+    #define SIMD_ISA_NAMESPACE sse2
+#endif
+
 namespace Simd
 {
-
+inline namespace SIMD_ISA_NAMESPACE
+{
+#if defined(SIMD_ARCH_X86)
     struct int4
     {
         __m128i vec;
@@ -84,7 +161,7 @@ namespace Simd
         forceinline int4 SIMD_VECTORCALL operator<<(int4 rhs) const noexcept
         {
             #if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX2)
-                return _mm_srlv_epi32(vec, rhs.vec);
+                return _mm_sllv_epi32(vec, rhs.vec);
             #else
                 alignas(16) int a[4], b[4];
                 _mm_store_si128(reinterpret_cast<__m128i*>(a), vec);
@@ -131,20 +208,29 @@ namespace Simd
 
         forceinline float4() = default;
         forceinline float4(float x, float y, float z, float w) noexcept: vec(_mm_set_ps(w, z, y, x)) {}
-        forceinline float4(float* p) noexcept: vec(_mm_load_ps(p)) {}
+        forceinline float4(const float* p) noexcept: vec(_mm_load_ps(p)) {}
         forceinline float4(float x) noexcept: vec(_mm_set1_ps(x)) {}
 
         forceinline float4 SIMD_VECTORCALL operator+(float4 rhs) const noexcept {return _mm_add_ps(vec, rhs.vec);}
         forceinline float4 SIMD_VECTORCALL operator-(float4 rhs) const noexcept {return _mm_sub_ps(vec, rhs.vec);}
         forceinline float4 SIMD_VECTORCALL operator*(float4 rhs) const noexcept {return _mm_mul_ps(vec, rhs.vec);}
         forceinline float4 SIMD_VECTORCALL operator/(float4 rhs) const {return _mm_div_ps(vec, rhs.vec);}
+        forceinline float4 SIMD_VECTORCALL operator-() const noexcept {return _mm_xor_ps(vec, _mm_set1_ps(-0.0f));}
+
+        forceinline float4 SIMD_VECTORCALL operator+=(float4 rhs) noexcept {vec = _mm_add_ps(vec, rhs.vec); return *this;}
+        forceinline float4 SIMD_VECTORCALL operator-=(float4 rhs) noexcept {vec = _mm_sub_ps(vec, rhs.vec); return *this;}
+        forceinline float4 SIMD_VECTORCALL operator*=(float4 rhs) noexcept {vec = _mm_mul_ps(vec, rhs.vec); return *this;}
+        forceinline float4 SIMD_VECTORCALL operator/=(float4 rhs) {vec = _mm_div_ps(vec, rhs.vec); return *this;}
+
+        forceinline float4 SIMD_VECTORCALL operator&(float4 rhs) const noexcept {return _mm_and_ps(vec, rhs.vec);}
+        forceinline float4 SIMD_VECTORCALL operator&(int4 rhs) const noexcept {return _mm_and_ps(vec, _mm_castsi128_ps(rhs.vec));}
 
-        forceinline int4 SIMD_VECTORCALL operator>(float4 rhs) const {return _mm_cmpgt_ps(vec, rhs.vec);}
-        forceinline int4 SIMD_VECTORCALL operator<(float4 rhs) const {return _mm_cmplt_ps(vec, rhs.vec);}
-        forceinline int4 SIMD_VECTORCALL operator>=(float4 rhs) const {return _mm_cmpge_ps(vec, rhs.vec);}
-        forceinline int4 SIMD_VECTORCALL operator<=(float4 rhs) const {return _mm_cmple_ps(vec, rhs.vec);}
-        forceinline int4 SIMD_VECTORCALL operator==(float4 rhs) const noexcept {return _mm_cmpeq_ps(vec, rhs.vec);}
-        forceinline int4 SIMD_VECTORCALL operator!=(float4 rhs) const noexcept {return _mm_cmpneq_ps(vec, rhs.vec);}
+        forceinline int4 SIMD_VECTORCALL operator>(float4 rhs) const {return _mm_castps_si128(_mm_cmpgt_ps(vec, rhs.vec));}
+        forceinline int4 SIMD_VECTORCALL operator<(float4 rhs) const {return _mm_castps_si128(_mm_cmplt_ps(vec, rhs.vec));}
+        forceinline int4 SIMD_VECTORCALL operator>=(float4 rhs) const {return _mm_castps_si128(_mm_cmpge_ps(vec, rhs.vec));}
+        forceinline int4 SIMD_VECTORCALL operator<=(float4 rhs) const {return _mm_castps_si128(_mm_cmple_ps(vec, rhs.vec));}
+        forceinline int4 SIMD_VECTORCALL operator==(float4 rhs) const noexcept {return _mm_castps_si128(_mm_cmpeq_ps(vec, rhs.vec));}
+        forceinline int4 SIMD_VECTORCALL operator!=(float4 rhs) const noexcept {return _mm_castps_si128(_mm_cmpneq_ps(vec, rhs.vec));}
 
         forceinline explicit float4(const int4& v) noexcept: vec(_mm_castsi128_ps(v.vec)) {}
         forceinline explicit operator int4() const noexcept {return _mm_castps_si128(vec);}
@@ -156,10 +242,15 @@ namespace Simd
             return arr[i];
         }
 
+        static forceinline float4 loadUnaligned(const float* p) noexcept {return _mm_loadu_ps(p);}
+        forceinline void store(float* p) const noexcept {_mm_store_ps(p, vec);}
+        forceinline void storeUnaligned(float* p) const noexcept {_mm_storeu_ps(p, vec);}
+
         forceinline operator __m128() const noexcept {return vec;}
         forceinline float4(__m128 v) noexcept: vec(v) {}
     };
 
+#if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX2)
     struct int8
     {
         __m256i vec;
@@ -174,7 +265,7 @@ namespace Simd
 
         forceinline int8 SIMD_VECTORCALL operator+(int8 rhs) const noexcept {return _mm256_add_epi32(vec, rhs.vec);}
         forceinline int8 SIMD_VECTORCALL operator-(int8 rhs) const noexcept {return _mm256_sub_epi32(vec, rhs.vec);}
-        forceinline int8 SIMD_VECTORCALL operator*(int8 rhs) const noexcept {return _mm256_mul_epi32(vec, rhs.vec);}
+        forceinline int8 SIMD_VECTORCALL operator*(int8 rhs) const noexcept {return _mm256_mullo_epi32(vec, rhs.vec);}
         forceinline int8 SIMD_VECTORCALL operator/(int8 rhs) const
         {
             alignas(32) int a[8], b[8];
@@ -191,7 +282,7 @@ namespace Simd
         forceinline int8 SIMD_VECTORCALL operator<<(int bits) const noexcept {return _mm256_slli_epi32(vec, bits);}
         forceinline int8 SIMD_VECTORCALL operator>>(int bits) const noexcept {return _mm256_srai_epi32(vec, bits);}
 
-        forceinline int8 SIMD_VECTORCALL operator<<(int8 rhs) const noexcept {return _mm256_srlv_epi32(vec, rhs.vec);}
+        forceinline int8 SIMD_VECTORCALL operator<<(int8 rhs) const noexcept {return _mm256_sllv_epi32(vec, rhs.vec);}
         forceinline int8 SIMD_VECTORCALL operator>>(int8 rhs) const noexcept {return _mm256_srav_epi32(vec, rhs.vec);}
 
         forceinline int8 SIMD_VECTORCALL operator>(int8 rhs) const noexcept {return _mm256_cmpgt_epi32(vec, rhs.vec);}
@@ -222,23 +313,23 @@ namespace Simd
         forceinline float8() = default;
         forceinline float8(float x1, float x2, float x3, float x4, float x5, float x6, float x7, float x8) noexcept:
             vec(_mm256_set_ps(x8, x7, x6, x5, x4, x3, x2, x1)) {}
-        forceinline float8(float* p) noexcept: vec(_mm256_load_ps(p)) {}
+        forceinline float8(const float* p) noexcept: vec(_mm256_load_ps(p)) {}
         forceinline float8(float x) noexcept: vec(_mm256_set1_ps(x)) {}        
 
         forceinline float8 SIMD_VECTORCALL operator+(float8 rhs) const noexcept {return _mm256_add_ps(vec, rhs.vec);}
         forceinline float8 SIMD_VECTORCALL operator-(float8 rhs) const noexcept {return _mm256_sub_ps(vec, rhs.vec);}
         forceinline float8 SIMD_VECTORCALL operator*(float8 rhs) const noexcept {return _mm256_mul_ps(vec, rhs.vec);}
         forceinline float8 SIMD_VECTORCALL operator/(float8 rhs) const {return _mm256_div_ps(vec, rhs.vec);}
+        forceinline float8 SIMD_VECTORCALL operator-() const noexcept {return _mm256_xor_ps(vec, _mm256_set1_ps(-0.0f));}
 
         forceinline float8 SIMD_VECTORCALL operator+=(const float8 rhs) noexcept {vec = _mm256_add_ps(vec, rhs.vec); return *this;}
         forceinline float8 SIMD_VECTORCALL operator-=(float8 rhs) noexcept {vec = _mm256_sub_ps(vec, rhs.vec); return *this;}
         forceinline float8 SIMD_VECTORCALL operator*=(float8 rhs) noexcept {vec = _mm256_mul_ps(vec, rhs.vec); return *this;}
         forceinline float8 SIMD_VECTORCALL operator/=(float8 rhs) {vec = _mm256_div_ps(vec, rhs.vec); return *this;}
 
-        forceinline float8 SIMD_VECTORCALL operator&(float8 rhs) const noexcept {return _mm256_and_si256(vec, rhs.vec);}
-        forceinline float8 SIMD_VECTORCALL operator&(int8 rhs) const noexcept {return _mm256_and_si256(vec, float8(rhs.vec));}
+        forceinline float8 SIMD_VECTORCALL operator&(float8 rhs) const noexcept {return _mm256_and_ps(vec, rhs.vec);}
+        forceinline float8 SIMD_VECTORCALL operator&(int8 rhs) const noexcept {return _mm256_and_ps(vec, _mm256_castsi256_ps(rhs.vec));}
 
-    #if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX2)
         forceinline int8 SIMD_VECTORCALL operator>(float8 rhs) const {return int8(float8(_mm256_cmp_ps(vec, rhs.vec, _CMP_GT_OQ)));}
         forceinline int8 SIMD_VECTORCALL operator<(float8 rhs) const {return int8(float8(_mm256_cmp_ps(vec, rhs.vec, _CMP_LT_OQ)));}
         forceinline int8 SIMD_VECTORCALL operator>=(float8 rhs) const {return int8(float8(_mm256_cmp_ps(vec, rhs.vec, _CMP_GE_OQ)));}
@@ -248,7 +339,6 @@ namespace Simd
 
         forceinline explicit float8(const int8& v): vec(_mm256_castsi256_ps(v.vec)) {}
         forceinline explicit operator int8() const noexcept {return _mm256_castps_si256(vec);}
-    #endif
 
         forceinline float operator[](int i) const
         {
@@ -257,6 +347,10 @@ namespace Simd
             return arr[i];
         }
 
+        static forceinline float8 loadUnaligned(const float* p) noexcept {return _mm256_loadu_ps(p);}
+        forceinline void store(float* p) const noexcept {_mm256_store_ps(p, vec);}
+        forceinline void storeUnaligned(float* p) const noexcept {_mm256_storeu_ps(p, vec);}
+
         forceinline operator __m256() const noexcept {return vec;}
         forceinline float8(__m256 v) noexcept: vec(v) {}
 
@@ -284,6 +378,244 @@ namespace Simd
             return _mm_cvtss_f32(sum);
         }
     };
+#endif
+
+#if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX512)
+    struct int16
+    {
+        __m512i vec;
+
+        enum {VectorSize = 16};
+
+        forceinline int16() = default;
+        forceinline int16(int* p) noexcept: vec(_mm512_load_si512(p)) {}
+        forceinline int16(int x) noexcept: vec(_mm512_set1_epi32(x)) {}
+
+        /// Expands a comparison mask to all-ones / all-zeros lanes
+        static forceinline int16 fromMask(__mmask16 mask) noexcept {return _mm512_maskz_set1_epi32(mask, -1);}
+
+        forceinline int16 SIMD_VECTORCALL operator+(int16 rhs) const noexcept {return _mm512_add_epi32(vec, rhs.vec);}
+        forceinline int16 SIMD_VECTORCALL operator-(int16 rhs) const noexcept {return _mm512_sub_epi32(vec, rhs.vec);}
+        forceinline int16 SIMD_VECTORCALL operator*(int16 rhs) const noexcept {return _mm512_mullo_epi32(vec, rhs.vec);}
+        forceinline int16 SIMD_VECTORCALL operator/(int16 rhs) const
+        {
+            alignas(64) int a[16], b[16];
+            _mm512_store_si512(a, vec);
+            _mm512_store_si512(b, rhs.vec);
+            for (int i = 0; i < 16; i++) a[i] /= b[i];
+            return _mm512_load_si512(a);
+        }
+
+        forceinline int16 SIMD_VECTORCALL operator&(int16 rhs) const noexcept {return _mm512_and_si512(vec, rhs.vec);}
+        forceinline int16 SIMD_VECTORCALL operator|(int16 rhs) const noexcept {return _mm512_or_si512(vec, rhs.vec);}
+        forceinline int16 SIMD_VECTORCALL operator^(int16 rhs) const noexcept {return _mm512_xor_si512(vec, rhs.vec);}
+        forceinline int16 SIMD_VECTORCALL operator~() const noexcept {return _mm512_xor_si512(vec, _mm512_set1_epi32(-1));}
+
+        forceinline int16 SIMD_VECTORCALL operator<<(int bits) const noexcept {return _mm512_slli_epi32(vec, bits);}
+        forceinline int16 SIMD_VECTORCALL operator>>(int bits) const noexcept {return _mm512_srai_epi32(vec, bits);}
+
+        forceinline int16 SIMD_VECTORCALL operator<<(int16 rhs) const noexcept {return _mm512_sllv_epi32(vec, rhs.vec);}
+        forceinline int16 SIMD_VECTORCALL operator>>(int16 rhs) const noexcept {return _mm512_srav_epi32(vec, rhs.vec);}
+
+        forceinline int16 SIMD_VECTORCALL operator>(int16 rhs) const noexcept {return fromMask(_mm512_cmpgt_epi32_mask(vec, rhs.vec));}
+        forceinline int16 SIMD_VECTORCALL operator<(int16 rhs) const noexcept {return fromMask(_mm512_cmplt_epi32_mask(vec, rhs.vec));}
+        forceinline int16 SIMD_VECTORCALL operator>=(int16 rhs) const noexcept {return fromMask(_mm512_cmpge_epi32_mask(vec, rhs.vec));}
+        forceinline int16 SIMD_VECTORCALL operator<=(int16 rhs) const noexcept {return fromMask(_mm512_cmple_epi32_mask(vec, rhs.vec));}
+        forceinline int16 SIMD_VECTORCALL operator==(int16 rhs) const noexcept {return fromMask(_mm512_cmpeq_epi32_mask(vec, rhs.vec));}
+        forceinline int16 SIMD_VECTORCALL operator!=(int16 rhs) const noexcept {return fromMask(_mm512_cmpneq_epi32_mask(vec, rhs.vec));}
+
+        forceinline int operator[](int i) const
+        {
+            alignas(64) int arr[16];
+            _mm512_store_si512(arr, vec);
+            return arr[i];
+        }
+
+        forceinline int16(__m512i v) noexcept: vec(v) {}
+        forceinline operator __m512i() const {return vec;}
+    };
+
+    struct float16
+    {
+        __m512 vec;
+
+        enum {VectorSize = 16};
+
+        forceinline float16() = default;
+        forceinline float16(const float* p) noexcept: vec(_mm512_load_ps(p)) {}
+        forceinline float16(float x) noexcept: vec(_mm512_set1_ps(x)) {}
+
+        forceinline float16 SIMD_VECTORCALL operator+(float16 rhs) const noexcept {return _mm512_add_ps(vec, rhs.vec);}
+        forceinline float16 SIMD_VECTORCALL operator-(float16 rhs) const noexcept {return _mm512_sub_ps(vec, rhs.vec);}
+        forceinline float16 SIMD_VECTORCALL operator*(float16 rhs) const noexcept {return _mm512_mul_ps(vec, rhs.vec);}
+        forceinline float16 SIMD_VECTORCALL operator/(float16 rhs) const {return _mm512_div_ps(vec, rhs.vec);}
+        forceinline float16 SIMD_VECTORCALL operator-() const noexcept
+        {
+            return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(vec), _mm512_set1_epi32(0x80000000)));
+        }
+
+        forceinline float16 SIMD_VECTORCALL operator+=(float16 rhs) noexcept {vec = _mm512_add_ps(vec, rhs.vec); return *this;}
+        forceinline float16 SIMD_VECTORCALL operator-=(float16 rhs) noexcept {vec = _mm512_sub_ps(vec, rhs.vec); return *this;}
+        forceinline float16 SIMD_VECTORCALL operator*=(float16 rhs) noexcept {vec = _mm512_mul_ps(vec, rhs.vec); return *this;}
+        forceinline float16 SIMD_VECTORCALL operator/=(float16 rhs) {vec = _mm512_div_ps(vec, rhs.vec); return *this;}
+
+        // Float bitwise ops need AVX-512DQ, so go through the integer domain
+        forceinline float16 SIMD_VECTORCALL operator&(float16 rhs) const noexcept
+        {
+            return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(vec), _mm512_castps_si512(rhs.vec)));
+        }
+        forceinline float16 SIMD_VECTORCALL operator&(int16 rhs) const noexcept
+        {
+            return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(vec), rhs.vec));
+        }
+
+        forceinline int16 SIMD_VECTORCALL operator>(float16 rhs) const {return int16::fromMask(_mm512_cmp_ps_mask(vec, rhs.vec, _CMP_GT_OQ));}
+        forceinline int16 SIMD_VECTORCALL operator<(float16 rhs) const {return int16::fromMask(_mm512_cmp_ps_mask(vec, rhs.vec, _CMP_LT_OQ));}
+        forceinline int16 SIMD_VECTORCALL operator>=(float16 rhs) const {return int16::fromMask(_mm512_cmp_ps_mask(vec, rhs.vec, _CMP_GE_OQ));}
+        forceinline int16 SIMD_VECTORCALL operator<=(float16 rhs) const {return int16::fromMask(_mm512_cmp_ps_mask(vec, rhs.vec, _CMP_LE_OQ));}
+        forceinline int16 SIMD_VECTORCALL operator==(float16 rhs) const noexcept {return int16::fromMask(_mm512_cmp_ps_mask(vec, rhs.vec, _CMP_EQ_OQ));}
+        forceinline int16 SIMD_VECTORCALL operator!=(float16 rhs) const noexcept {return int16::fromMask(_mm512_cmp_ps_mask(vec, rhs.vec, _CMP_NEQ_OQ));}
+
+        forceinline explicit float16(const int16& v) noexcept: vec(_mm512_castsi512_ps(v.vec)) {}
+        forceinline explicit operator int16() const noexcept {return _mm512_castps_si512(vec);}
+
+        forceinline float operator[](int i) const
+        {
+            alignas(64) float arr[16];
+            _mm512_store_ps(arr, vec);
+            return arr[i];
+        }
+
+        static forceinline float16 loadUnaligned(const float* p) noexcept {return _mm512_loadu_ps(p);}
+        forceinline void store(float* p) const noexcept {_mm512_store_ps(p, vec);}
+        forceinline void storeUnaligned(float* p) const noexcept {_mm512_storeu_ps(p, vec);}
+
+        forceinline operator __m512() const noexcept {return vec;}
+        forceinline float16(__m512 v) noexcept: vec(v) {}
+
+        float sum() const { return _mm512_reduce_add_ps(vec); }
+    };
+#endif
+
+#elif defined(SIMD_ARCH_NEON)
+    struct int4
+    {
+        int32x4_t vec;
+
+        enum {VectorSize = 4};
+
+        forceinline int4() = default;
+        forceinline int4(int x, int y, int z, int w) noexcept
+        {
+            alignas(16) const int v[4] = {x, y, z, w};
+            vec = vld1q_s32(v);
+        }
+        forceinline int4(int* p) noexcept: vec(vld1q_s32(p)) {}
+        forceinline int4(int x) noexcept: vec(vdupq_n_s32(x)) {}
+
+        forceinline int4 SIMD_VECTORCALL operator+(int4 rhs) const noexcept {return vaddq_s32(vec, rhs.vec);}
+        forceinline int4 SIMD_VECTORCALL operator-(int4 rhs) const noexcept {return vsubq_s32(vec, rhs.vec);}
+        forceinline int4 SIMD_VECTORCALL operator*(int4 rhs) const noexcept {return vmulq_s32(vec, rhs.vec);}
+        forceinline int4 SIMD_VECTORCALL operator/(int4 rhs) const
+        {
+            alignas(16) int a[4], b[4];
+            vst1q_s32(a, vec);
+            vst1q_s32(b, rhs.vec);
+            return {a[0] / b[0], a[1] / b[1], a[2] / b[2], a[3] / b[3]};
+        }
+
+        forceinline int4 SIMD_VECTORCALL operator&(int4 rhs) const noexcept {return vandq_s32(vec, rhs.vec);}
+        forceinline int4 SIMD_VECTORCALL operator|(int4 rhs) const noexcept {return vorrq_s32(vec, rhs.vec);}
+        forceinline int4 SIMD_VECTORCALL operator^(int4 rhs) const noexcept {return veorq_s32(vec, rhs.vec);}
+        forceinline int4 SIMD_VECTORCALL operator~() const noexcept {return vmvnq_s32(vec);}
+
+        // vshlq shifts right for negative counts, arithmetically for signed lanes
+        forceinline int4 SIMD_VECTORCALL operator<<(int bits) const noexcept {return vshlq_s32(vec, vdupq_n_s32(bits));}
+        forceinline int4 SIMD_VECTORCALL operator>>(int bits) const noexcept {return vshlq_s32(vec, vdupq_n_s32(-bits));}
+
+        forceinline int4 SIMD_VECTORCALL operator<<(int4 rhs) const noexcept {return vshlq_s32(vec, rhs.vec);}
+        forceinline int4 SIMD_VECTORCALL operator>>(int4 rhs) const noexcept {return vshlq_s32(vec, vnegq_s32(rhs.vec));}
+
+        forceinline int4 SIMD_VECTORCALL operator>(int4 rhs) const noexcept {return vreinterpretq_s32_u32(vcgtq_s32(vec, rhs.vec));}
+        forceinline int4 SIMD_VECTORCALL operator<(int4 rhs) const noexcept {return vreinterpretq_s32_u32(vcltq_s32(vec, rhs.vec));}
+        forceinline int4 SIMD_VECTORCALL operator>=(int4 rhs) const noexcept {return vreinterpretq_s32_u32(vcgeq_s32(vec, rhs.vec));}
+        forceinline int4 SIMD_VECTORCALL operator<=(int4 rhs) const noexcept {return vreinterpretq_s32_u32(vcleq_s32(vec, rhs.vec));}
+        forceinline int4 SIMD_VECTORCALL operator==(int4 rhs) const noexcept {return vreinterpretq_s32_u32(vceqq_s32(vec, rhs.vec));}
+        forceinline int4 SIMD_VECTORCALL operator!=(int4 rhs) const noexcept {return ~operator==(rhs);}
+
+        forceinline int operator[](int i) const
+        {
+            alignas(16) int arr[4];
+            vst1q_s32(arr, vec);
+            return arr[i];
+        }
+
+        forceinline int4(int32x4_t v) noexcept: vec(v) {}
+        forceinline operator int32x4_t() const {return vec;}
+    };
+
+    struct float4
+    {
+        float32x4_t vec;
+
+        enum {VectorSize = 4};
+
+        forceinline float4() = default;
+        forceinline float4(float x, float y, float z, float w) noexcept
+        {
+            alignas(16) const float v[4] = {x, y, z, w};
+            vec = vld1q_f32(v);
+        }
+        forceinline float4(const float* p) noexcept: vec(vld1q_f32(p)) {}
+        forceinline float4(float x) noexcept: vec(vdupq_n_f32(x)) {}
+
+        forceinline float4 SIMD_VECTORCALL operator+(float4 rhs) const noexcept {return vaddq_f32(vec, rhs.vec);}
+        forceinline float4 SIMD_VECTORCALL operator-(float4 rhs) const noexcept {return vsubq_f32(vec, rhs.vec);}
+        forceinline float4 SIMD_VECTORCALL operator*(float4 rhs) const noexcept {return vmulq_f32(vec, rhs.vec);}
+        forceinline float4 SIMD_VECTORCALL operator/(float4 rhs) const {return vdivq_f32(vec, rhs.vec);}
+        forceinline float4 SIMD_VECTORCALL operator-() const noexcept {return vnegq_f32(vec);}
+
+        forceinline float4 SIMD_VECTORCALL operator+=(float4 rhs) noexcept {vec = vaddq_f32(vec, rhs.vec); return *this;}
+        forceinline float4 SIMD_VECTORCALL operator-=(float4 rhs) noexcept {vec = vsubq_f32(vec, rhs.vec); return *this;}
+        forceinline float4 SIMD_VECTORCALL operator*=(float4 rhs) noexcept {vec = vmulq_f32(vec, rhs.vec); return *this;}
+        forceinline float4 SIMD_VECTORCALL operator/=(float4 rhs) {vec = vdivq_f32(vec, rhs.vec); return *this;}
+
+        forceinline float4 SIMD_VECTORCALL operator&(float4 rhs) const noexcept
+        {
+            return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vec), vreinterpretq_u32_f32(rhs.vec)));
+        }
+        forceinline float4 SIMD_VECTORCALL operator&(int4 rhs) const noexcept
+        {
+            return vreinterpretq_f32_s32(vandq_s32(vreinterpretq_s32_f32(vec), rhs.vec));
+        }
+
+        forceinline int4 SIMD_VECTORCALL operator>(float4 rhs) const {return vreinterpretq_s32_u32(vcgtq_f32(vec, rhs.vec));}
+        forceinline int4 SIMD_VECTORCALL operator<(float4 rhs) const {return vreinterpretq_s32_u32(vcltq_f32(vec, rhs.vec));}
+        forceinline int4 SIMD_VECTORCALL operator>=(float4 rhs) const {return vreinterpretq_s32_u32(vcgeq_f32(vec, rhs.vec));}
+        forceinline int4 SIMD_VECTORCALL operator<=(float4 rhs) const {return vreinterpretq_s32_u32(vcleq_f32(vec, rhs.vec));}
+        forceinline int4 SIMD_VECTORCALL operator==(float4 rhs) const noexcept {return vreinterpretq_s32_u32(vceqq_f32(vec, rhs.vec));}
+        forceinline int4 SIMD_VECTORCALL operator!=(float4 rhs) const noexcept {return vreinterpretq_s32_u32(vmvnq_u32(vceqq_f32(vec, rhs.vec)));}
+
+        forceinline explicit float4(const int4& v) noexcept: vec(vreinterpretq_f32_s32(v.vec)) {}
+        forceinline explicit operator int4() const noexcept {return vreinterpretq_s32_f32(vec);}
+
+        forceinline float operator[](int i) const
+        {
+            alignas(16) float arr[4];
+            vst1q_f32(arr, vec);
+            return arr[i];
+        }
+
+        static forceinline float4 loadUnaligned(const float* p) noexcept {return vld1q_f32(p);}
+        forceinline void store(float* p) const noexcept {vst1q_f32(p, vec);}
+        forceinline void storeUnaligned(float* p) const noexcept {vst1q_f32(p, vec);}
+
+        forceinline operator float32x4_t() const noexcept {return vec;}
+        forceinline float4(float32x4_t v) noexcept: vec(v) {}
+
+        float sum() const { return vaddvq_f32(vec); }
+    };
+#endif
 
     /* #region TYPE  PROPERTIES */
     /// Scalar type on which vector type is based
@@ -311,6 +643,44 @@ namespace Simd
     }
     /* #endregion */
 
+    /* #region MASK REDUCTION */
+#if defined(SIMD_ARCH_X86)
+    /// True if any lane of the mask is set
+    forceinline bool any(int4 mask) noexcept { return _mm_movemask_ps(_mm_castsi128_ps(mask.vec)) != 0; }
+    /// True if all lanes of the mask are set
+    forceinline bool all(int4 mask) noexcept { return _mm_movemask_ps(_mm_castsi128_ps(mask.vec)) == 0xF; }
+  #if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX2)
+    forceinline bool any(int8 mask) noexcept { return _mm256_movemask_ps(_mm256_castsi256_ps(mask.vec)) != 0; }
+    forceinline bool all(int8 mask) noexcept { return _mm256_movemask_ps(_mm256_castsi256_ps(mask.vec)) == 0xFF; }
+  #endif
+  #if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX512)
+    forceinline bool any(int16 mask) noexcept { return _mm512_test_epi32_mask(mask.vec, mask.vec) != 0; }
+    forceinline bool all(int16 mask) noexcept { return _mm512_test_epi32_mask(mask.vec, mask.vec) == 0xFFFF; }
+  #endif
+#elif defined(SIMD_ARCH_NEON)
+    forceinline bool any(int4 mask) noexcept { return vmaxvq_u32(vreinterpretq_u32_s32(mask.vec)) != 0; }
+    forceinline bool all(int4 mask) noexcept { return vminvq_u32(vreinterpretq_u32_s32(mask.vec)) != 0; }
+#endif
+    /* #endregion */
+
+    /* #region LOGICAL SHIFT */
+    /// Shift right shifting in zeros, treating lanes as unsigned (operator>> is arithmetic)
+#if defined(SIMD_ARCH_X86)
+    forceinline int4 shiftRightLogical(int4 x, int bits) noexcept { return _mm_srli_epi32(x.vec, bits); }
+  #if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX2)
+    forceinline int8 shiftRightLogical(int8 x, int bits) noexcept { return _mm256_srli_epi32(x.vec, bits); }
+  #endif
+  #if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX512)
+    forceinline int16 shiftRightLogical(int16 x, int bits) noexcept { return _mm512_srli_epi32(x.vec, bits); }
+  #endif
+#elif defined(SIMD_ARCH_NEON)
+    forceinline int4 shiftRightLogical(int4 x, int bits) noexcept
+    {
+        return vreinterpretq_s32_u32(vshlq_u32(vreinterpretq_u32_s32(x.vec), vdupq_n_s32(-bits)));
+    }
+#endif
+    /* #endregion */
+
     /* #region ROUNDING */
 
     template<typename T> forceinline 
@@ -319,17 +689,37 @@ namespace Simd
         return T(intAnalogOf<T>(v) & 0x7FFFFFFF);
     }
 
+#if defined(SIMD_ARCH_X86)
+  #if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_SSE4_1)
     forceinline float4 floor(float4 x) { return _mm_floor_ps(x); }
-    forceinline float8 floor(float8 x) { return _mm256_floor_ps(x); }
-
     forceinline float4 ceil(float4 x) { return _mm_ceil_ps(x); }
-    forceinline float8 ceil(float8 x) { return _mm256_ceil_ps(x); }
-
     forceinline float4 round(float4 x) { return _mm_round_ps(x, _MM_FROUND_TO_NEAREST_INT); }
-    forceinline float8 round(float8 x) { return _mm256_round_ps(x, _MM_FROUND_TO_NEAREST_INT); }
-
     forceinline float4 trunc(float4 x) { return _mm_round_ps(x, _MM_FROUND_TO_ZERO); }
+  #else
+    // SSE2 goes through int conversion, valid for |x| < 2^31
+    forceinline float4 trunc(float4 x) { return _mm_cvtepi32_ps(_mm_cvttps_epi32(x)); }
+    forceinline float4 round(float4 x) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(x)); }
+    forceinline float4 floor(float4 x) { const float4 t = trunc(x); return t - (float4(1.0f) & (t > x)); }
+    forceinline float4 ceil(float4 x) { const float4 t = trunc(x); return t + (float4(1.0f) & (t < x)); }
+  #endif
+  #if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX2)
+    forceinline float8 floor(float8 x) { return _mm256_floor_ps(x); }
+    forceinline float8 ceil(float8 x) { return _mm256_ceil_ps(x); }
+    forceinline float8 round(float8 x) { return _mm256_round_ps(x, _MM_FROUND_TO_NEAREST_INT); }
     forceinline float8 trunc(float8 x) { return _mm256_round_ps(x, _MM_FROUND_TO_ZERO); }
+  #endif
+  #if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX512)
+    forceinline float16 floor(float16 x) { return _mm512_roundscale_ps(x, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    forceinline float16 ceil(float16 x) { return _mm512_roundscale_ps(x, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC); }
+    forceinline float16 round(float16 x) { return _mm512_roundscale_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    forceinline float16 trunc(float16 x) { return _mm512_roundscale_ps(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+  #endif
+#elif defined(SIMD_ARCH_NEON)
+    forceinline float4 floor(float4 x) { return vrndmq_f32(x); }
+    forceinline float4 ceil(float4 x) { return vrndpq_f32(x); }
+    forceinline float4 round(float4 x) { return vrndnq_f32(x); }
+    forceinline float4 trunc(float4 x) { return vrndq_f32(x); }
+#endif
 
     template<typename T> 
     forceinline T mod1f(T x) noexcept
@@ -343,12 +733,57 @@ namespace Simd
         return x - floor(x);
     }
 
+    /// Fractional part with truncation semantics, like Math::frac (negative for negative x)
+    forceinline float4 frac(float4 x) noexcept { return x - trunc(x); }
+#if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX2)
+    forceinline float8 frac(float8 x) noexcept { return x - trunc(x); }
+#endif
+#if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX512)
+    forceinline float16 frac(float16 x) noexcept { return x - trunc(x); }
+#endif
+
+#if defined(SIMD_ARCH_X86)
+    /// Float to int conversion with truncation toward zero
+    forceinline int4 toInt(float4 x) { return _mm_cvttps_epi32(x); }
+    /// Int to float conversion
+    forceinline float4 toFloat(int4 x) { return _mm_cvtepi32_ps(x); }
     forceinline float4 recip(float4 x) { return _mm_rcp_ps(x); }
+  #if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX2)
+    forceinline int8 toInt(float8 x) { return _mm256_cvttps_epi32(x); }
+    forceinline float8 toFloat(int8 x) { return _mm256_cvtepi32_ps(x); }
     forceinline float8 recip(float8 x) { return _mm256_rcp_ps(x); }
+  #endif
+  #if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX512)
+    forceinline int16 toInt(float16 x) { return _mm512_cvttps_epi32(x); }
+    forceinline float16 toFloat(int16 x) { return _mm512_cvtepi32_ps(x); }
+    forceinline float16 recip(float16 x) { return _mm512_rcp14_ps(x); }
+  #endif
+#elif defined(SIMD_ARCH_NEON)
+    forceinline int4 toInt(float4 x) { return vcvtq_s32_f32(x); }
+    forceinline float4 toFloat(int4 x) { return vcvtq_f32_s32(x); }
+    forceinline float4 recip(float4 x) { return vrecpeq_f32(x); }
+#endif
     /* #endregion */
 
+#if defined(SIMD_ARCH_X86)
+  #if defined(SIMD_HAS_FMA)
     forceinline float4 fma(float4 a, float4 b, float4 c) { return _mm_fmadd_ps(a, b, c); }
+  #else
+    forceinline float4 fma(float4 a, float4 b, float4 c) { return a * b + c; }
+  #endif
+  #if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX2)
+    #if defined(SIMD_HAS_FMA)
     forceinline float8 fma(float8 a, float8 b, float8 c) { return _mm256_fmadd_ps(a, b, c); }
+    #else
+    forceinline float8 fma(float8 a, float8 b, float8 c) { return a * b + c; }
+    #endif
+  #endif
+  #if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX512)
+    forceinline float16 fma(float16 a, float16 b, float16 c) { return _mm512_fmadd_ps(a, b, c); }
+  #endif
+#elif defined(SIMD_ARCH_NEON)
+    forceinline float4 fma(float4 a, float4 b, float4 c) { return vfmaq_f32(c, a, b); }
+#endif
 
     template<typename T> 
     forceinline T sign(T x) noexcept
@@ -358,11 +793,21 @@ namespace Simd
         return ternary(T(1.0f), T(-1.0f), mask);
     }
 
+#if defined(SIMD_ARCH_X86)
     forceinline float4 sqrt(float4 x) { return _mm_sqrt_ps(x); }
-    forceinline float8 sqrt(float8 x) { return _mm256_sqrt_ps(x); }
-
     forceinline float4 rsqrt(float4 x) { return _mm_rsqrt_ps(x); }
+  #if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX2)
+    forceinline float8 sqrt(float8 x) { return _mm256_sqrt_ps(x); }
     forceinline float8 rsqrt(float8 x) { return _mm256_rsqrt_ps(x); }
+  #endif
+  #if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX512)
+    forceinline float16 sqrt(float16 x) { return _mm512_sqrt_ps(x); }
+    forceinline float16 rsqrt(float16 x) { return _mm512_rsqrt14_ps(x); }
+  #endif
+#elif defined(SIMD_ARCH_NEON)
+    forceinline float4 sqrt(float4 x) { return vsqrtq_f32(x); }
+    forceinline float4 rsqrt(float4 x) { return vrsqrteq_f32(x); }
+#endif
 
     template<typename T>
     forceinline T mag(T x, T y) { return sqrt(x * x + y * y); }
@@ -371,24 +816,136 @@ namespace Simd
     forceinline T rmag(T x, T y) { return rsqrt(x * x + y * y); }
 
     /* #region MIN AND MAX */
-    
+#if defined(SIMD_ARCH_X86)
     forceinline float4 min (float4 a, float4 b) noexcept { return _mm_min_ps(a, b); }
-    forceinline float8 min (float8 a, float8 b) noexcept { return _mm256_min_ps(a, b); }
-
     forceinline float4 max (float4 a, float4 b) noexcept { return _mm_max_ps(a, b); }
+  #if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX2)
+    forceinline float8 min (float8 a, float8 b) noexcept { return _mm256_min_ps(a, b); }
     forceinline float8 max (float8 a, float8 b) noexcept { return _mm256_max_ps(a, b); }
 
     forceinline float8 clamp(float8 x, float8 a, float8 b) noexcept
     {
         return max(min(x, b), a);
     }
-
-
+  #endif
+  #if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX512)
+    forceinline float16 min (float16 a, float16 b) noexcept { return _mm512_min_ps(a, b); }
+    forceinline float16 max (float16 a, float16 b) noexcept { return _mm512_max_ps(a, b); }
+  #endif
+#elif defined(SIMD_ARCH_NEON)
+    forceinline float4 min (float4 a, float4 b) noexcept { return vminq_f32(a, b); }
+    forceinline float4 max (float4 a, float4 b) noexcept { return vmaxq_f32(a, b); }
+#endif
     /* #endregion */
 
     template<typename T>
     forceinline T lerp(T a, T b, T t) noexcept { return a * (T(1.0f) - t) + b * t; }
 
+    /* #region EXPONENTIALS AND LOGARITHMS */
+
+    /// Fast 2^x, same algorithm and accuracy as Math::fastExp2. Input is clamped to [-126, 126].
+    template<typename T> forceinline
+    std::enable_if_t<std::is_same<scalarTypeOf<T>, float>::value, T> SIMD_VECTORCALL fastExp2(T x) noexcept
+    {
+        using I = intAnalogOf<T>;
+
+        x = min(max(x, T(-126.0f)), T(126.0f));
+
+        const T k = round(x);
+        const T f = x - k;
+
+        T p = T(1.535336188319500e-4f);
+        p = fma(p, f, T(1.339887440266574e-3f));
+        p = fma(p, f, T(9.618437357674640e-3f));
+        p = fma(p, f, T(5.550332471162809e-2f));
+        p = fma(p, f, T(2.402264791363012e-1f));
+        p = fma(p, f, T(6.931472028550421e-1f));
+        p = fma(p, f, T(1.0f));
+
+        return p * T((toInt(k) + I(127)) << 23);
+    }
+
+    /// Fast log2(x) for positive, normal x, same algorithm and accuracy as Math::fastLog2
+    template<typename T> forceinline
+    std::enable_if_t<std::is_same<scalarTypeOf<T>, float>::value, T> SIMD_VECTORCALL fastLog2(T x) noexcept
+    {
+        using I = intAnalogOf<T>;
+
+        const I bits = I(x);
+
+        T e = toFloat(((bits >> 23) & I(0xFF)) - I(127));
+        T m = T((bits & I(0x7FFFFF)) | I(0x3F800000));
+
+        const I upper = m > T(1.41421356237309505f);
+        m = ternary(m * T(0.5f), m, upper);
+        e = e + (T(1.0f) & upper);
+
+        const T t = (m - T(1.0f)) / (m + T(1.0f));
+        const T t2 = t * t;
+
+        T p = fma(t2, T(0.412198583111132f), T(0.577078016355585f));
+        p = fma(p, t2, T(0.961796693925976f));
+        p = fma(p, t2, T(2.885390081777927f));
+
+        return fma(p, t, e);
+    }
+    /* #endregion */
+
+    /* #region TRIGONOMETRY */
+
+    /**
+     * Fast atan2(y, x) in [-pi, pi], max absolute error ~2e-6 rad.
+     * atan of min(|x|, |y|) / max(|x|, |y|) by a minimax polynomial, then folded
+     * into the quadrant. Returns 0 for (0, 0).
+     */
+    template<typename T> forceinline
+    std::enable_if_t<std::is_same<scalarTypeOf<T>, float>::value, T> SIMD_VECTORCALL fastAtan2(T y, T x) noexcept
+    {
+        using I = intAnalogOf<T>;
+
+        const T ax = abs(x);
+        const T ay = abs(y);
+
+        const T a = min(ax, ay) / max(max(ax, ay), T(1.0e-30f));
+        const T s = a * a;
+
+        T p = T(-0.01172120f);
+        p = fma(p, s, T(0.05265332f));
+        p = fma(p, s, T(-0.11643287f));
+        p = fma(p, s, T(0.19354346f));
+        p = fma(p, s, T(-0.33262347f));
+        p = fma(p, s, T(0.99997726f));
+
+        T r = p * a;
+
+        const I steep = ay > ax;
+        r = ternary(T(1.57079632679f) - r, r, steep);
+
+        const I left = x < T(0.0f);
+        r = ternary(T(3.14159265359f) - r, r, left);
+
+        const I below = y < T(0.0f);
+        return ternary(-r, r, below);
+    }
+    /* #endregion */
+    /* #region GATHER */
+
+    /// Loads base[indices[i]] into lane i
+#if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX2)
+    forceinline float4 gather(const float* base, int4 indices) noexcept { return _mm_i32gather_ps(base, indices, 4); }
+    forceinline float8 gather(const float* base, int8 indices) noexcept { return _mm256_i32gather_ps(base, indices, 4); }
+#else
+    forceinline float4 gather(const float* base, int4 indices) noexcept
+    {
+        return float4(base[indices[0]], base[indices[1]], base[indices[2]], base[indices[3]]);
+    }
+#endif
+#if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX512)
+    forceinline float16 gather(const float* base, int16 indices) noexcept { return _mm512_i32gather_ps(indices, base, 4); }
+#endif
+    /* #endregion */
+
+#if(SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX2)
     /* #region SHUFFLE AND PERMUTATION*/
         
         static inline float8 permute (float8 v, int8 indices) noexcept
@@ -396,6 +953,12 @@ namespace Simd
             return _mm256_permutevar8x32_ps(v, indices);
         }
 
+    /*
+        Namespace-scope vector constants are dynamically initialized without optimization.
+        Translation units that may load on CPUs below their own ISA level (per-ISA
+        dispatch kernels) define SIMD_NO_GLOBAL_CONSTANTS to leave them out.
+    */
+    #ifndef SIMD_NO_GLOBAL_CONSTANTS
         static const int8 perm1 = {1,2,3,4,5,6,7,0};
         static const int8 perm2 = {2,3,4,5,6,7,0,1};
         static const int8 perm3 = {3,4,5,6,7,0,1,2};
@@ -403,10 +966,12 @@ namespace Simd
         static const int8 perm5 = {5,6,7,0,1,2,3,4};
         static const int8 perm6 = {6,7,0,1,2,3,4,5};
         static const int8 perm7 = {7,0,1,2,3,4,5,6};
+    #endif
     /* #endregion */
 
     /* #region MASKS */
         constexpr int m1 = 0xFFFFFFFF;
+    #ifndef SIMD_NO_GLOBAL_CONSTANTS
         static const int8 mask1 = {m1,0,0,0,0,0,0,0};
         static const int8 mask2 = {m1,m1,0,0,0,0,0,0};
         static const int8 mask3 = {m1,m1,m1,0,0,0,0,0};
@@ -424,6 +989,9 @@ namespace Simd
         static const int8 mask6n = ~mask6;
         static const int8 mask7n = ~mask7;
         static const int8 mask8n = ~mask8;
+    #endif
     /* #endregion */
+#endif
 
-}
\ No newline at end of file
+}
+}
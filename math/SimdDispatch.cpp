@@ -0,0 +1,98 @@
+#include "SimdDispatch.h"
+
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+    #define SIMD_DISPATCH_MSVC_X86 1
+#elif defined(__x86_64__) || defined(__i386__)
+    #define SIMD_DISPATCH_GNU_X86 1
+#endif
+
+namespace Simd
+{
+#if defined(SIMD_DISPATCH_MSVC_X86)
+    static bool supportsMsvc(Isa isa) noexcept
+    {
+        int info[4];
+
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+
+        __cpuid(info, 1);
+        const bool sse2 = (info[3] & (1 << 26)) != 0;
+        const bool fma = (info[2] & (1 << 12)) != 0;
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+
+        // The OS must save the YMM (and for AVX-512, opmask and ZMM) registers
+        const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+        const bool ymmState = (xcr0 & 0x6) == 0x6;
+        const bool zmmState = (xcr0 & 0xE6) == 0xE6;
+
+        bool avx2 = false;
+        bool avx512f = false;
+        if (maxLeaf >= 7)
+        {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+            avx512f = (info[1] & (1 << 16)) != 0;
+        }
+
+        switch (isa)
+        {
+            case Isa::SSE2: return sse2;
+            case Isa::AVX2: return avx2 && fma && ymmState;
+            case Isa::AVX512: return avx512f && avx2 && fma && zmmState;
+            default: return false;
+        }
+    }
+#endif
+
+    bool isSupported(Isa isa) noexcept
+    {
+        if (isa == Isa::Scalar) return true;
+
+    #if defined(SIMD_DISPATCH_MSVC_X86)
+        return supportsMsvc(isa);
+    #elif defined(SIMD_DISPATCH_GNU_X86)
+        // libgcc / compiler-rt also check that the OS enables the AVX register state
+        switch (isa)
+        {
+            case Isa::SSE2: return __builtin_cpu_supports("sse2");
+            case Isa::AVX2: return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+            case Isa::AVX512: return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+            default: return false;
+        }
+    #elif defined(__aarch64__)
+        return isa == Isa::NEON;
+    #else
+        (void) isa;
+        return false;
+    #endif
+    }
+
+    Isa getBestIsa() noexcept
+    {
+        static const Isa best = []
+        {
+            if (isSupported(Isa::NEON)) return Isa::NEON;
+            if (isSupported(Isa::AVX512)) return Isa::AVX512;
+            if (isSupported(Isa::AVX2)) return Isa::AVX2;
+            if (isSupported(Isa::SSE2)) return Isa::SSE2;
+            return Isa::Scalar;
+        }();
+
+        return best;
+    }
+
+    const char* getIsaName(Isa isa) noexcept
+    {
+        switch (isa)
+        {
+            case Isa::Scalar: return "Scalar";
+            case Isa::SSE2: return "SSE2";
+            case Isa::AVX2: return "AVX2";
+            case Isa::AVX512: return "AVX-512";
+            case Isa::NEON: return "NEON";
+        }
+        return "unknown";
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+namespace Simd
+{
+    /**
+     * Instruction sets with their own kernel builds, in increasing order of width.
+     *
+     * This header does not include Simd.h, so it can be used from translation
+     * units compiled for the baseline of the target architecture.
+     */
+    enum class Isa
+    {
+        Scalar,     // plain C++, any target
+        SSE2,       // float4
+        AVX2,       // float8, with FMA
+        AVX512,     // float16 (AVX-512F)
+        NEON        // float4 (AArch64)
+    };
+
+    /**
+     * @brief Check whether the running CPU (and OS, for the AVX register state) supports an instruction set.
+     */
+    bool isSupported(Isa isa) noexcept;
+
+    /**
+     * @brief Widest instruction set supported by the running CPU. Detected once.
+     */
+    Isa getBestIsa() noexcept;
+
+    const char* getIsaName(Isa isa) noexcept;
+}
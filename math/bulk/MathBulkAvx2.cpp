@@ -0,0 +1,14 @@
+#include "MathBulkKernels.h"
+
+namespace Ath::Math::Bulk
+{
+    const Kernels* getAvx2Kernels() noexcept
+    {
+    #if SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX2 && defined(SIMD_HAS_FMA)
+        static const Kernels kernels = KernelSet<Simd::float8>::make(Simd::Isa::AVX2);
+        return &kernels;
+    #else
+        return nullptr;
+    #endif
+    }
+}
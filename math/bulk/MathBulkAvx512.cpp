@@ -0,0 +1,14 @@
+#include "MathBulkKernels.h"
+
+namespace Ath::Math::Bulk
+{
+    const Kernels* getAvx512Kernels() noexcept
+    {
+    #if SIMD_SSE_LEVEL >= SIMD_SSE_LEVEL_AVX512
+        static const Kernels kernels = KernelSet<Simd::float16>::make(Simd::Isa::AVX512);
+        return &kernels;
+    #else
+        return nullptr;
+    #endif
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+/*
+    Kernel bodies shared by the per-ISA translation units in this directory.
+    Only include from those: each one is compiled with its own instruction set
+    flags, and everything here has internal linkage so the copies never merge.
+*/
+#define SIMD_NO_GLOBAL_CONSTANTS 1
+
+#include "../MathBulk.h"
+#include "../Math.h"
+#include "../Simd.h"
+
+namespace Ath::Math::Bulk
+{
+    namespace
+    {
+        /**
+         * @brief Apply op to every element of in, writing to out.
+         *
+         * @tparam V Any Simd float vector type
+         * @param op Callable V(V)
+         */
+        template <typename V, typename Op>
+        inline void apply(const float* in, float* out, int n, Op op) noexcept
+        {
+            constexpr int width = V::VectorSize;
+
+            int i = 0;
+            for (; i + width <= n; i += width)
+                op(V::loadUnaligned(in + i)).storeUnaligned(out + i);
+
+            if (i < n)
+            {
+                // Pad with the last element so the kernel sees in-range values.
+                // No std::min: a weak out-of-line copy built with this TU's flags could be shared
+                alignas(64) float tail[width];
+                for (int k = 0; k < width; k++) tail[k] = in[i + k < n ? i + k : n - 1];
+
+                op(V(tail)).store(tail);
+
+                for (int k = 0; i + k < n; k++) out[i + k] = tail[k];
+            }
+        }
+
+        template <typename V>
+        struct KernelSet
+        {
+            static void sin2pi5(const float* in, float* out, int n) noexcept
+            {
+                apply<V>(in, out, n, [](V x) { return Math::sin2pi5(x); });
+            }
+
+            static void sin2pi7(const float* in, float* out, int n) noexcept
+            {
+                apply<V>(in, out, n, [](V x) { return Math::sin2pi7(x); });
+            }
+
+            static void sin2pi9(const float* in, float* out, int n) noexcept
+            {
+                apply<V>(in, out, n, [](V x) { return Math::sin2pi9(x); });
+            }
+
+            static void fastTan(const float* in, float* out, int n) noexcept
+            {
+                apply<V>(in, out, n, [](V x) { return Math::fastTan(x); });
+            }
+
+            static void exp2(const float* in, float* out, int n) noexcept
+            {
+                apply<V>(in, out, n, [](V x) { return Simd::fastExp2(x); });
+            }
+
+            static void log2(const float* in, float* out, int n) noexcept
+            {
+                apply<V>(in, out, n, [](V x) { return Simd::fastLog2(x); });
+            }
+
+            static void noteToFrequency(const float* in, float* out, int n, float referenceFrequency) noexcept
+            {
+                const V reference = referenceFrequency;
+                apply<V>(in, out, n, [reference](V p) { return Math::fastNoteToFrequency(p, reference); });
+            }
+
+            static void frequencyToNote(const float* in, float* out, int n, float referenceFrequency) noexcept
+            {
+                const V reference = referenceFrequency;
+                apply<V>(in, out, n, [reference](V f) { return Math::fastFrequencyToNote(f, reference); });
+            }
+
+            static void semitonesToFrequencyRatio(const float* in, float* out, int n) noexcept
+            {
+                apply<V>(in, out, n, [](V s) { return Math::fastSemitonesToFrequencyRatio(s); });
+            }
+
+            static void decibelsToAmplitude(const float* in, float* out, int n) noexcept
+            {
+                apply<V>(in, out, n, [](V db) { return Math::fastDecibelsToAmplitude(db); });
+            }
+
+            static void amplitudeToDecibels(const float* in, float* out, int n) noexcept
+            {
+                apply<V>(in, out, n, [](V gain) { return Math::fastAmplitudeToDecibels(gain); });
+            }
+
+            static Kernels make(Simd::Isa isa) noexcept
+            {
+                return { isa,
+                         &sin2pi5, &sin2pi7, &sin2pi9, &fastTan,
+                         &exp2, &log2,
+                         &noteToFrequency, &frequencyToNote, &semitonesToFrequencyRatio,
+                         &decibelsToAmplitude, &amplitudeToDecibels };
+            }
+        };
+    }
+}
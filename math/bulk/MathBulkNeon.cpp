@@ -0,0 +1,14 @@
+#include "MathBulkKernels.h"
+
+namespace Ath::Math::Bulk
+{
+    const Kernels* getNeonKernels() noexcept
+    {
+    #if defined(SIMD_ARCH_NEON)
+        static const Kernels kernels = KernelSet<Simd::float4>::make(Simd::Isa::NEON);
+        return &kernels;
+    #else
+        return nullptr;
+    #endif
+    }
+}
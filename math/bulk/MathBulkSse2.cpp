@@ -0,0 +1,14 @@
+#include "MathBulkKernels.h"
+
+namespace Ath::Math::Bulk
+{
+    const Kernels* getSse2Kernels() noexcept
+    {
+    #if defined(SIMD_ARCH_X86)
+        static const Kernels kernels = KernelSet<Simd::float4>::make(Simd::Isa::SSE2);
+        return &kernels;
+    #else
+        return nullptr;
+    #endif
+    }
+}
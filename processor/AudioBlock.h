@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+namespace Ath::Processor
+{
+
+    /**
+     * @brief Non-owning view of a non-interleaved multi-channel buffer.
+     *
+     * Holds one pointer per channel, the number of samples and the alignment
+     * that every channel's first sample satisfies. The channel pointers are
+     * stored in the view, so sub-block views are made without touching the
+     * samples or allocating, and getChannels() can be handed straight to
+     * channel-parallel kernels such as BiquadBank::processBlock.
+     *
+     * A view holds at most maximumNumberOfChannels (16) channels. The
+     * constructor keeps the first 16 of a wider buffer and drops the rest, so
+     * split wider buffers into several views.
+     *
+     * @tparam SampleType Sample type, const-qualified for read-only views
+     */
+    template <typename SampleType>
+    class AudioBlock
+    {
+    public:
+        static constexpr int maximumNumberOfChannels = 16;
+
+        /** Largest alignment reported, in bytes (one cache line, enough for any vector type) */
+        static constexpr int maximumAlignment = 64;
+
+    private:
+        std::array<SampleType*, maximumNumberOfChannels> channels {};
+        int numberOfChannels = 0;
+        int numberOfSamples = 0;
+        int alignment = maximumAlignment;
+
+        void updateAlignment()
+        {
+            alignment = maximumAlignment;
+            for (int c = 0; c < numberOfChannels; c++)
+            {
+                const auto address = reinterpret_cast<std::uintptr_t> (channels[c]);
+                const auto lowestBit = address & (~address + 1);
+                if (lowestBit != 0 && lowestBit < static_cast<std::uintptr_t> (alignment))
+                    alignment = static_cast<int> (lowestBit);
+            }
+        }
+
+    public:
+        AudioBlock() = default;
+
+        /**
+         * @param channelPointers One pointer per channel
+         * @param numberOfChannels Number of channels, at most maximumNumberOfChannels;
+         *        any further channels are not part of the view and are left untouched
+         * @param numberOfSamples Number of samples in every channel
+         */
+        AudioBlock(SampleType* const* channelPointers, int numberOfChannels, int numberOfSamples)
+            : numberOfChannels(std::clamp(numberOfChannels, 0, maximumNumberOfChannels)),
+              numberOfSamples(std::max(numberOfSamples, 0))
+        {
+            std::copy_n(channelPointers, this->numberOfChannels, channels.begin());
+            updateAlignment();
+        }
+
+        /**
+         * @brief Single-channel view.
+         */
+        AudioBlock(SampleType* samples, int numberOfSamples) : AudioBlock(&samples, 1, numberOfSamples) {}
+
+        /**
+         * @brief Read-only view of a writable block.
+         */
+        template <typename OtherType>
+            requires (std::is_same_v<SampleType, const OtherType>)
+        AudioBlock(const AudioBlock<OtherType>& other)
+            : numberOfChannels(other.getNumberOfChannels()),
+              numberOfSamples(other.getNumberOfSamples()),
+              alignment(other.getAlignment())
+        {
+            std::copy_n(other.getChannels(), numberOfChannels, channels.begin());
+        }
+
+        int getNumberOfChannels() const { return numberOfChannels; }
+
+        int getNumberOfSamples() const { return numberOfSamples; }
+
+        /**
+         * @return Alignment in bytes of the first sample of every channel, a power of two up to maximumAlignment
+         */
+        int getAlignment() const { return alignment; }
+
+        /**
+         * @param bytes Power of two, e.g. alignof(Simd::float8)
+         */
+        bool isAligned(int bytes) const { return alignment % bytes == 0; }
+
+        SampleType* getChannel(int channel) const { return channels[channel]; }
+
+        /**
+         * @brief Array of numberOfChannels channel pointers, valid as long as the view.
+         */
+        SampleType* const* getChannels() const { return channels.data(); }
+
+        /**
+         * @brief View of samples [start, start + length) of every channel. Arguments are clamped to the block.
+         */
+        AudioBlock getSubBlock(int start, int length) const
+        {
+            start = std::clamp(start, 0, numberOfSamples);
+            length = std::clamp(length, 0, numberOfSamples - start);
+
+            AudioBlock sub;
+            sub.numberOfChannels = numberOfChannels;
+            sub.numberOfSamples = length;
+
+            for (int c = 0; c < numberOfChannels; c++)
+                sub.channels[c] = channels[c] + start;
+
+            sub.updateAlignment();
+            return sub;
+        }
+
+        /**
+         * @brief View of a range of channels, e.g. one channel of a stereo block.
+         */
+        AudioBlock getChannelRange(int firstChannel, int count) const
+        {
+            firstChannel = std::clamp(firstChannel, 0, numberOfChannels);
+            count = std::clamp(count, 0, numberOfChannels - firstChannel);
+
+            return AudioBlock(channels.data() + firstChannel, count, numberOfSamples);
+        }
+
+        void clear() const
+            requires (!std::is_const_v<SampleType>)
+        {
+            for (int c = 0; c < numberOfChannels; c++)
+                std::fill_n(channels[c], numberOfSamples, SampleType(0));
+        }
+    };
+}
@@ -0,0 +1,297 @@
+// 64-bit off_t for fseeko and ftello on 32-bit POSIX systems; before any system header
+#if !defined(_WIN32) && !defined(_FILE_OFFSET_BITS)
+    #define _FILE_OFFSET_BITS 64
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#if !defined(_WIN32)
+    #include <sys/types.h>
+#endif
+
+#include "AudioFile.h"
+
+namespace Ath::Processor
+{
+
+    namespace
+    {
+        // stdio buffer per open file; large sequential transfers keep disks and page cache streaming
+        constexpr size_t fileBufferSize = size_t (1) << 20;
+
+        constexpr uint16_t formatPcm = 1;
+        constexpr uint16_t formatFloat = 3;
+        constexpr uint16_t formatExtensible = 0xFFFE;
+
+        uint16_t readU16 (const unsigned char* p) { return static_cast<uint16_t> (p[0] | (p[1] << 8)); }
+        uint32_t readU32 (const unsigned char* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t> (p[3]) << 24); }
+
+        void writeU16 (unsigned char* p, uint16_t v) { p[0] = v & 0xFF; p[1] = v >> 8; }
+        void writeU32 (unsigned char* p, uint32_t v) { for (int i = 0; i < 4; i++) p[i] = (v >> (8 * i)) & 0xFF; }
+
+        // fseek and ftell take a long, which is 32 bits on Windows; files and chunks beyond 2 GiB need these
+        int seekFile (std::FILE* file, int64_t offset, int origin)
+        {
+        #if defined(_WIN32)
+            return _fseeki64 (file, offset, origin);
+        #else
+            return fseeko (file, static_cast<off_t> (offset), origin);
+        #endif
+        }
+
+        int64_t tellFile (std::FILE* file)
+        {
+        #if defined(_WIN32)
+            return _ftelli64 (file);
+        #else
+            return static_cast<int64_t> (ftello (file));
+        #endif
+        }
+
+        float decodePcm (const char* p, int bytesPerSample)
+        {
+            const auto* u = reinterpret_cast<const unsigned char*> (p);
+
+            switch (bytesPerSample)
+            {
+                case 2: return static_cast<int16_t> (readU16 (u)) * (1.0f / 32768.0f);
+                case 3: return (static_cast<int32_t> (static_cast<uint32_t> (u[0] << 8 | u[1] << 16 | u[2] << 24)) >> 8) * (1.0f / 8388608.0f);
+                case 4: return static_cast<float> (static_cast<int32_t> (readU32 (u)) * (1.0 / 2147483648.0));
+                default: return 0.0f;
+            }
+        }
+    }
+
+    // ============================================================
+    // Reader
+    // ============================================================
+
+    AudioFileReader::~AudioFileReader() { close(); }
+
+    bool AudioFileReader::openFile (const std::string& path)
+    {
+        close();
+
+        file = std::fopen (path.c_str(), "rb");
+        if (file == nullptr) return false;
+
+        fileBuffer.resize (fileBufferSize);
+        std::setvbuf (file, fileBuffer.data(), _IOFBF, fileBuffer.size());
+        return true;
+    }
+
+    bool AudioFileReader::openWav (const std::string& path)
+    {
+        if (!openFile (path)) return false;
+
+        unsigned char riff[12];
+        if (std::fread (riff, 1, sizeof (riff), file) != sizeof (riff)
+            || std::memcmp (riff, "RIFF", 4) != 0 || std::memcmp (riff + 8, "WAVE", 4) != 0)
+        {
+            close();
+            return false;
+        }
+
+        bool haveFormat = false;
+
+        // Chunks until "data"; "fmt " has to come first
+        while (true)
+        {
+            unsigned char header[8];
+            if (std::fread (header, 1, sizeof (header), file) != sizeof (header)) break;
+
+            const uint32_t size = readU32 (header + 4);
+
+            if (std::memcmp (header, "fmt ", 4) == 0 && size >= 16 && size <= 64)
+            {
+                unsigned char fmt[64];
+                if (std::fread (fmt, 1, size, file) != size) break;
+                if (size % 2 != 0) seekFile (file, 1, SEEK_CUR);
+
+                uint16_t tag = readU16 (fmt);
+                if (tag == formatExtensible && size >= 26) tag = readU16 (fmt + 24);
+
+                numberOfChannels = readU16 (fmt + 2);
+                sampleRate = static_cast<float> (readU32 (fmt + 4));
+                frameBytes = readU16 (fmt + 12);
+                bytesPerSample = readU16 (fmt + 14) / 8;
+
+                isFloat = tag == formatFloat;
+                haveFormat = numberOfChannels > 0 && frameBytes >= bytesPerSample * numberOfChannels
+                             && ((isFloat && bytesPerSample == 4) || (tag == formatPcm && bytesPerSample >= 2 && bytesPerSample <= 4));
+                if (!haveFormat) break;
+            }
+            else if (std::memcmp (header, "data", 4) == 0 && haveFormat)
+            {
+                numberOfFrames = size / frameBytes;
+                framesLeft = numberOfFrames;
+                return true;
+            }
+            else if (seekFile (file, static_cast<int64_t> (size) + size % 2, SEEK_CUR) != 0)
+            {
+                break;
+            }
+        }
+
+        close();
+        return false;
+    }
+
+    bool AudioFileReader::openRaw (const std::string& path, int channels, float rate)
+    {
+        if (channels <= 0 || !openFile (path)) return false;
+
+        numberOfChannels = channels;
+        sampleRate = rate;
+        bytesPerSample = 4;
+        frameBytes = 4 * channels;
+        isFloat = true;
+
+        seekFile (file, 0, SEEK_END);
+        const int64_t bytes = tellFile (file);
+        seekFile (file, 0, SEEK_SET);
+
+        numberOfFrames = bytes > 0 ? bytes / frameBytes : 0;
+        framesLeft = numberOfFrames;
+        return true;
+    }
+
+    bool AudioFileReader::open (const std::string& path, AudioFileFormat format, int rawNumberOfChannels, float rawSampleRate)
+    {
+        return format == AudioFileFormat::Wav ? openWav (path) : openRaw (path, rawNumberOfChannels, rawSampleRate);
+    }
+
+    void AudioFileReader::close()
+    {
+        if (file != nullptr) std::fclose (file);
+        file = nullptr;
+        framesLeft = 0;
+    }
+
+    int AudioFileReader::read (const AudioBlock<float>& block)
+    {
+        if (file == nullptr || block.getNumberOfChannels() == 0) return 0;
+
+        const int wanted = static_cast<int> (std::min<int64_t> (block.getNumberOfSamples(), framesLeft));
+
+        chunk.resize (static_cast<size_t> (wanted) * frameBytes);
+        const int frames = static_cast<int> (std::fread (chunk.data(), frameBytes, static_cast<size_t> (wanted), file));
+        framesLeft -= frames;
+
+        for (int c = 0; c < block.getNumberOfChannels(); c++)
+        {
+            float* out = block.getChannel (c);
+            const char* in = chunk.data() + (c % numberOfChannels) * bytesPerSample;
+
+            if (isFloat)
+            {
+                for (int i = 0; i < frames; i++) std::memcpy (out + i, in + static_cast<size_t> (i) * frameBytes, sizeof (float));
+            }
+            else
+            {
+                for (int i = 0; i < frames; i++) out[i] = decodePcm (in + static_cast<size_t> (i) * frameBytes, bytesPerSample);
+            }
+        }
+
+        return frames;
+    }
+
+    // ============================================================
+    // Writer
+    // ============================================================
+
+    AudioFileWriter::~AudioFileWriter() { close(); }
+
+    bool AudioFileWriter::writeWavHeader (uint32_t dataBytes)
+    {
+        unsigned char header[44];
+
+        std::memcpy (header, "RIFF", 4);
+        writeU32 (header + 4, 36 + dataBytes);
+        std::memcpy (header + 8, "WAVEfmt ", 8);
+        writeU32 (header + 16, 16);
+        writeU16 (header + 20, formatFloat);
+        writeU16 (header + 22, static_cast<uint16_t> (numberOfChannels));
+        writeU32 (header + 24, static_cast<uint32_t> (sampleRate));
+        writeU32 (header + 28, static_cast<uint32_t> (sampleRate) * 4 * numberOfChannels);
+        writeU16 (header + 32, static_cast<uint16_t> (4 * numberOfChannels));
+        writeU16 (header + 34, 32);
+        std::memcpy (header + 36, "data", 4);
+        writeU32 (header + 40, dataBytes);
+
+        return std::fwrite (header, 1, sizeof (header), file) == sizeof (header);
+    }
+
+    bool AudioFileWriter::open (const std::string& path, AudioFileFormat newFormat, int channels, float rate)
+    {
+        close();
+
+        if (channels <= 0 || channels > AudioBlock<float>::maximumNumberOfChannels) return false;
+
+        file = std::fopen (path.c_str(), "wb");
+        if (file == nullptr) return false;
+
+        fileBuffer.resize (fileBufferSize);
+        std::setvbuf (file, fileBuffer.data(), _IOFBF, fileBuffer.size());
+
+        format = newFormat;
+        numberOfChannels = channels;
+        sampleRate = rate;
+        framesWritten = 0;
+        failed = false;
+
+        // Placeholder sizes, completed in close()
+        if (format == AudioFileFormat::Wav && !writeWavHeader (0)) failed = true;
+
+        return true;
+    }
+
+    bool AudioFileWriter::write (const AudioBlock<const float>& block)
+    {
+        if (file == nullptr || failed) return false;
+
+        const int frames = block.getNumberOfSamples();
+        const int channels = std::min (numberOfChannels, block.getNumberOfChannels());
+
+        if (format == AudioFileFormat::Wav)
+        {
+            const int64_t bytes = (framesWritten + frames) * 4 * static_cast<int64_t> (numberOfChannels);
+            if (bytes > std::numeric_limits<uint32_t>::max() - 36) return false;
+        }
+
+        chunk.assign (static_cast<size_t> (frames) * numberOfChannels, 0.0f);
+
+        for (int c = 0; c < channels; c++)
+        {
+            const float* in = block.getChannel (c);
+            for (int i = 0; i < frames; i++) chunk[static_cast<size_t> (i) * numberOfChannels + c] = in[i];
+        }
+
+        if (std::fwrite (chunk.data(), sizeof (float), chunk.size(), file) != chunk.size())
+        {
+            failed = true;
+            return false;
+        }
+
+        framesWritten += frames;
+        return true;
+    }
+
+    bool AudioFileWriter::close()
+    {
+        if (file == nullptr) return !failed;
+
+        if (format == AudioFileFormat::Wav && !failed)
+        {
+            const auto dataBytes = static_cast<uint32_t> (framesWritten * 4 * numberOfChannels);
+            if (seekFile (file, 0, SEEK_SET) != 0 || !writeWavHeader (dataBytes)) failed = true;
+        }
+
+        if (std::fclose (file) != 0) failed = true;
+        file = nullptr;
+
+        return !failed;
+    }
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "AudioBlock.h"
+
+namespace Ath::Processor
+{
+
+    enum class AudioFileFormat
+    {
+        Wav,        // RIFF WAVE; reads 16, 24 and 32-bit PCM and 32-bit float, writes 32-bit float
+        RawFloat    // headerless interleaved 32-bit float
+    };
+
+    /**
+     * @brief Streaming reader for WAV and raw float files, for offline rendering.
+     *
+     * Reads a chunk of frames per call through a large stdio buffer and
+     * deinterleaves into an AudioBlock, so files of any length stream in
+     * constant memory. Samples are assumed little-endian, as on x86 and ARM.
+     */
+    class AudioFileReader
+    {
+    public:
+        AudioFileReader() = default;
+        ~AudioFileReader();
+
+        AudioFileReader (const AudioFileReader&) = delete;
+        AudioFileReader& operator= (const AudioFileReader&) = delete;
+
+        /**
+         * @brief Open a WAV file and read its header.
+         *
+         * @return false if the file cannot be opened or is not a supported WAV
+         */
+        bool openWav (const std::string& path);
+
+        /**
+         * @brief Open a headerless file of interleaved floats, whose layout the caller knows.
+         */
+        bool openRaw (const std::string& path, int numberOfChannels, float sampleRate);
+
+        bool open (const std::string& path, AudioFileFormat format, int rawNumberOfChannels, float rawSampleRate);
+
+        void close();
+
+        bool isOpen() const { return file != nullptr; }
+
+        int getNumberOfChannels() const { return numberOfChannels; }
+        float getSampleRate() const { return sampleRate; }
+        int64_t getNumberOfFrames() const { return numberOfFrames; }
+
+        /**
+         * @brief Read the next frames into the block. Block channels beyond the file's repeat its channels cyclically, so mono feeds stereo.
+         *
+         * @return Frames read, less than block.getNumberOfSamples() only at the end of the file
+         */
+        int read (const AudioBlock<float>& block);
+
+    private:
+        std::FILE* file = nullptr;
+        std::vector<char> fileBuffer;
+        std::vector<char> chunk;
+
+        int numberOfChannels = 0;
+        float sampleRate = 0.0f;
+        int64_t numberOfFrames = 0;
+        int64_t framesLeft = 0;
+
+        int bytesPerSample = 4;
+        int frameBytes = 4;    // block align: bytes from one frame to the next
+        bool isFloat = true;
+
+        bool openFile (const std::string& path);
+    };
+
+    /**
+     * @brief Streaming writer for 32-bit float WAV and raw float files.
+     *
+     * Interleaves each block into a chunk and writes it through a large stdio
+     * buffer; the WAV header is completed on close(). WAV is limited to 4 GiB
+     * of samples, use RawFloat beyond that.
+     */
+    class AudioFileWriter
+    {
+    public:
+        AudioFileWriter() = default;
+        ~AudioFileWriter();
+
+        AudioFileWriter (const AudioFileWriter&) = delete;
+        AudioFileWriter& operator= (const AudioFileWriter&) = delete;
+
+        bool open (const std::string& path, AudioFileFormat format, int numberOfChannels, float sampleRate);
+
+        /**
+         * @brief Write the header sizes and close the file.
+         *
+         * @return false if any write failed
+         */
+        bool close();
+
+        bool isOpen() const { return file != nullptr; }
+
+        /**
+         * @brief Append the first numberOfChannels channels of the block.
+         *
+         * @return false if the write failed or a WAV file would exceed 4 GiB
+         */
+        bool write (const AudioBlock<const float>& block);
+
+        int64_t getNumberOfFramesWritten() const { return framesWritten; }
+
+    private:
+        std::FILE* file = nullptr;
+        std::vector<char> fileBuffer;
+        std::vector<float> chunk;
+
+        AudioFileFormat format = AudioFileFormat::Wav;
+        int numberOfChannels = 0;
+        float sampleRate = 0.0f;
+        int64_t framesWritten = 0;
+        bool failed = false;
+
+        bool writeWavHeader (uint32_t dataBytes);
+    };
+}
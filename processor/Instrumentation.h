@@ -0,0 +1,208 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "../control/TripleBuffer.h"
+#include "../dsp/Context.h"
+
+/**
+ * Real-time load instrumentation, compiled in with ATH_DSP_INSTRUMENTATION=1
+ * (the ATH_DSP_INSTRUMENTATION CMake option). It must have the same value in
+ * every translation unit. When it is off, MidiAudioProcessor has no monitor
+ * and the macros below expand to nothing.
+ *
+ * Subsystems attribute their cost to a stage of a LoadMonitor with
+ *
+ *     ATH_DSP_SCOPED_TIMER(monitor, stageIndex);
+ *
+ * which times the rest of the enclosing scope.
+ */
+#ifndef ATH_DSP_INSTRUMENTATION
+#define ATH_DSP_INSTRUMENTATION 0
+#endif
+
+#define ATH_DSP_CONCAT_INNER(a, b) a##b
+#define ATH_DSP_CONCAT(a, b) ATH_DSP_CONCAT_INNER(a, b)
+
+#if ATH_DSP_INSTRUMENTATION
+#define ATH_DSP_SCOPED_TIMER(monitor, stage) ::Ath::Processor::ScopedTimer ATH_DSP_CONCAT(athDspScopedTimer, __LINE__) ((monitor), (stage))
+#else
+#define ATH_DSP_SCOPED_TIMER(monitor, stage) static_cast<void>(0)
+#endif
+
+namespace Ath::Processor
+{
+    /**
+     * @brief Statistics of a LoadMonitor, as seen by the reader thread.
+     *
+     * Load is the block's processing time over its deadline: 1 means the
+     * whole budget was used, above 1 is an xrun.
+     */
+    struct LoadSnapshot
+    {
+        static constexpr int numberOfLoadBins = 64;
+        static constexpr float loadBinWidth = 1.0f / 32.0f;      // bins cover 0 to 200 % of the deadline, the last also everything above
+
+        static constexpr int numberOfEventBins = 16;             // the last bin also counts sub-blocks with more events
+
+        static constexpr int maximumNumberOfStages = 16;
+
+        struct Stage
+        {
+            const char* name = nullptr;
+            uint64_t calls = 0;
+            double seconds = 0.0;
+            double lastBlockSeconds = 0.0;
+        };
+
+        uint64_t numberOfBlocks = 0;
+        uint64_t numberOfXruns = 0;
+        uint64_t numberOfSubBlocks = 0;
+        uint64_t numberOfEvents = 0;
+
+        float lastLoad = 0.0f;
+        float peakLoad = 0.0f;
+        double loadSum = 0.0;
+        double seconds = 0.0;
+
+        std::array<uint32_t, numberOfLoadBins> loadHistogram {};
+        std::array<uint32_t, numberOfEventBins> eventsPerSubBlock {};
+        std::array<Stage, maximumNumberOfStages> stages {};
+
+        float getAverageLoad() const { return numberOfBlocks ? static_cast<float>(loadSum / double(numberOfBlocks)) : 0.0f; }
+
+        /// Fraction of the deadline left by the last block; negative after an xrun
+        float getHeadroom() const { return 1.0f - lastLoad; }
+    };
+
+    /**
+     * @brief Block timing, load histogram, xrun and event statistics for one audio thread.
+     *
+     * The audio thread calls beginBlock(), addSubBlock() and endBlock() (or lets
+     * MidiAudioProcessor::process do it) and times stages with ScopedTimer. At
+     * the end of each block the statistics are published to a triple buffer,
+     * which another thread reads wait-free with getSnapshot().
+     *
+     * The deadline of a block is Context::maxSamplesPerBlock / Context::SR,
+     * the callback period of the host, or the block's own duration if it is longer.
+     */
+    class LoadMonitor
+    {
+        using Clock = std::chrono::steady_clock;
+
+        Control::TripleBuffer<LoadSnapshot> snapshots;
+
+        // Owned by the audio thread, copied to the snapshot at the end of each block
+        LoadSnapshot state;
+        std::array<double, LoadSnapshot::maximumNumberOfStages> blockStageSeconds {};
+
+        float sampleRate = 48000.0f;
+        int maxSamplesPerBlock = 1;
+
+        Clock::time_point blockStart;
+
+    public:
+        void setContext(const Dsp::Context context)
+        {
+            sampleRate = context.SR;
+            maxSamplesPerBlock = context.maxSamplesPerBlock;
+        }
+
+        /**
+         * @brief Name a stage for the snapshot. Call before processing starts.
+         *
+         * @param name Should outlive the monitor, e.g. a string literal
+         */
+        void setStageName(int stage, const char* name) { state.stages[stage].name = name; }
+
+        /**
+         * @brief Clear the statistics. Call when not processing.
+         */
+        void reset()
+        {
+            LoadSnapshot cleared;
+            for (int i = 0; i < LoadSnapshot::maximumNumberOfStages; i++) cleared.stages[i].name = state.stages[i].name;
+
+            state = cleared;
+            blockStageSeconds.fill(0.0);
+        }
+
+        inline void beginBlock() { blockStart = Clock::now(); }
+
+        /**
+         * @param numberOfEvents Events delivered before the sub-block was rendered
+         */
+        inline void addSubBlock(int numberOfEvents)
+        {
+            state.numberOfSubBlocks++;
+            state.numberOfEvents += static_cast<uint64_t>(numberOfEvents);
+            state.eventsPerSubBlock[std::min(numberOfEvents, LoadSnapshot::numberOfEventBins - 1)]++;
+        }
+
+        inline void addStageTime(int stage, double seconds)
+        {
+            blockStageSeconds[stage] += seconds;
+            state.stages[stage].calls++;
+        }
+
+        void endBlock(int numberOfSamples)
+        {
+            const double elapsed = std::chrono::duration<double>(Clock::now() - blockStart).count();
+            const double deadline = double(std::max(maxSamplesPerBlock, numberOfSamples)) / double(sampleRate);
+            const float load = static_cast<float>(elapsed / deadline);
+
+            state.numberOfBlocks++;
+            if (load > 1.0f) state.numberOfXruns++;
+
+            state.lastLoad = load;
+            state.peakLoad = std::max(state.peakLoad, load);
+            state.loadSum += load;
+            state.seconds += elapsed;
+
+            const int bin = std::min(static_cast<int>(load / LoadSnapshot::loadBinWidth), LoadSnapshot::numberOfLoadBins - 1);
+            state.loadHistogram[bin]++;
+
+            for (int i = 0; i < LoadSnapshot::maximumNumberOfStages; i++)
+            {
+                state.stages[i].seconds += blockStageSeconds[i];
+                state.stages[i].lastBlockSeconds = blockStageSeconds[i];
+                blockStageSeconds[i] = 0.0;
+            }
+
+            snapshots.getWriteBuffer() = state;
+            snapshots.publish();
+        }
+
+        /**
+         * @brief Reader side, from one thread other than the audio thread, e.g. a UI timer.
+         *
+         * @return The statistics as of the end of the latest block, valid until the next call
+         */
+        const LoadSnapshot& getSnapshot() { return snapshots.read(); }
+    };
+
+    /**
+     * @brief Adds the time until the end of its scope to a stage of a LoadMonitor. See ATH_DSP_SCOPED_TIMER.
+     */
+    class ScopedTimer
+    {
+        LoadMonitor& monitor;
+        int stage;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        ScopedTimer(LoadMonitor& monitorToUse, int stageIndex)
+            : monitor(monitorToUse), stage(stageIndex), start(std::chrono::steady_clock::now()) {}
+
+        ~ScopedTimer()
+        {
+            monitor.addStageTime(stage, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+    };
+}
@@ -1,57 +1,324 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
 #include "../control/Midi.h"
+#include "../dsp/AllocationGuard.h"
+#include "../dsp/Context.h"
+#include "../dsp/Denormals.h"
+#include "../dsp/ScratchArena.h"
+#include "AudioBlock.h"
+#include "Instrumentation.h"
 
 namespace Ath::Processor
 {
 
+    /**
+     * @brief Base class for processors that render audio between MIDI events.
+     *
+     * By default every event splits the block at its sample position, so events
+     * are sample accurate. With a minimum sub-block size above one sample, the
+     * block is only split at multiples of that size from the block start: events
+     * inside a granule are coalesced at its start, and parameter events (see
+     * isParameterEvent) do not split at all but go to handleParameterEvent, with
+     * their offset into the next rendered sub-block, to be used as ramp targets
+     * for smoothers.
+     *
+     * Events may arrive in any order. An already sorted list is checked in one
+     * pass; otherwise the events are ordered by sample position, keeping the
+     * order of events at the same position, in scratch memory reserved by
+     * reserveEvents(), room for defaultNumberOfReservedEvents by default.
+     * Longer lists are ordered in windows of the reserved size, one more pass
+     * over the list per window, still without allocating. The messages array
+     * itself is never modified.
+     *
+     * Audio is passed as an AudioBlock of non-interleaved channels; sub-blocks
+     * between events are views into it. Processors override either the
+     * multi-channel processBlock, to run all channels in one pass, or the mono
+     * one, which is then called once per channel.
+     *
+     * Overriding one overload of processBlock or process hides the others in
+     * the subclass, so a processor that only overrides the mono processBlock
+     * cannot be called with an AudioBlock through its own type. Bring the rest
+     * back with a using-declaration:
+     *
+     *     class GainProcessor : public MidiAudioProcessor
+     *     {
+     *     public:
+     *         using MidiAudioProcessor::processBlock;
+     *         void processBlock(float * buffer, int numberOfSamples) override;
+     *     };
+     *
+     * setContext() sizes a scratch arena for temporary buffers, see
+     * getScratchArena(), which process() resets at the start of every block.
+     * With ATH_DSP_DETECT_ALLOCATIONS on, any heap allocation inside process()
+     * aborts (see AllocationGuard.h).
+     *
+     * With ATH_DSP_INSTRUMENTATION on, process() reports every block and
+     * sub-block to the LoadMonitor returned by getLoadMonitor().
+     */
     class MidiAudioProcessor
     {
+        int minimumSubBlockSize = 1;
+
+        // (samplePosition << 32 | index) keys, so a plain sort is also stable
+        std::vector<uint64_t> order;
+
+        Dsp::ScratchArena scratchArena;
+        int numberOfScratchBuffers = 8;
+
+    #if ATH_DSP_INSTRUMENTATION
+        LoadMonitor loadMonitor;
+        int eventsSinceRender = 0;
+    #endif
+
+        void renderUpTo(const AudioBlock<float>& block, int& currentSample, int stopAtSample)
+        {
+            if (stopAtSample > currentSample)
+            {
+            #if ATH_DSP_INSTRUMENTATION
+                loadMonitor.addSubBlock(eventsSinceRender);
+                eventsSinceRender = 0;
+            #endif
+
+                processBlock(block.getSubBlock(currentSample, stopAtSample - currentSample));
+                currentSample = stopAtSample;
+            }
+        }
+
+        void dispatchEvent(const AudioBlock<float>& block, int& currentSample, const Control::Midi::MessageMeta& metadata)
+        {
+            const auto message = metadata.message;
+            const int position = std::clamp(metadata.samplePosition, 0, block.getNumberOfSamples());
+            const int granule = minimumSubBlockSize;
+
+            if (granule == 1)
+            {
+                renderUpTo(block, currentSample, position);
+                handleMidiEvent(message);
+            }
+            else if (isParameterEvent(message))
+            {
+                handleParameterEvent(message, std::max(position - currentSample, 0));
+            }
+            else
+            {
+                // Split at the start of the event's granule; events in the same granule share it
+                renderUpTo(block, currentSample, position - position % granule);
+                handleMidiEvent(message);
+            }
+
+        #if ATH_DSP_INSTRUMENTATION
+            eventsSinceRender++;
+        #endif
+        }
+
     public:
-        virtual void processBlock(float * buffer, int numberOfSamples)
+        /** Unsorted events per block ordered in one pass without reserveEvents() */
+        static constexpr int defaultNumberOfReservedEvents = 512;
+
+        MidiAudioProcessor() { reserveEvents(defaultNumberOfReservedEvents); }
+
+        virtual ~MidiAudioProcessor() = default;
+
+        virtual void processBlock([[maybe_unused]] float * buffer, [[maybe_unused]] int numberOfSamples)
+        {
+
+        }
+
+        /**
+         * @brief Process all channels of a sub-block. Calls the mono processBlock for each channel by default.
+         */
+        virtual void processBlock(AudioBlock<float> block)
+        {
+            for (int c = 0; c < block.getNumberOfChannels(); c++)
+                processBlock(block.getChannel(c), block.getNumberOfSamples());
+        }
+
+        virtual void handleMidiEvent([[maybe_unused]] Control::Midi::Message message)
+        {
+
+        }
+
+        /**
+         * @brief Receive a parameter event without a block split, when the minimum sub-block size is above one.
+         *
+         * Forwards to handleMidiEvent by default. Override to set a smoother
+         * target instead, reached over sampleOffset samples.
+         *
+         * @param message Parameter event
+         * @param sampleOffset Position of the event relative to the start of the next processBlock call
+         */
+        virtual void handleParameterEvent(Control::Midi::Message message, [[maybe_unused]] int sampleOffset)
         {
+            handleMidiEvent(message);
+        }
+
+        /**
+         * @brief Events that are delivered without splitting the block. Controllers
+         * (except channel mode messages), pitch bend and aftertouch by default.
+         */
+        virtual bool isParameterEvent(const Control::Midi::Message& message) const
+        {
+            using Control::Midi::MessageType;
 
+            switch (message.type())
+            {
+                case MessageType::ControlChange:
+                    return message.data1 < static_cast<unsigned char> (Control::Midi::ChannelModeMessages::AllSoundOff);
+                case MessageType::PitchBend:
+                case MessageType::Aftertouch:
+                case MessageType::ChannelAftertouch:
+                    return true;
+                default:
+                    return false;
+            }
         }
 
-        virtual void handleMidiEvent(Control::Midi::Message message)
+        /**
+         * @brief Set the granularity of block splits.
+         *
+         * @param numberOfSamples 1 for sample-accurate splits at every event (default), or e.g. 16 or 32
+         */
+        void setMinimumSubBlockSize(int numberOfSamples)
         {
+            minimumSubBlockSize = std::max(numberOfSamples, 1);
+        }
+
+        int getMinimumSubBlockSize() const { return minimumSubBlockSize; }
 
+        /**
+         * @brief Size the scratch arena for context.maxSamplesPerBlock. Overrides should call this too.
+         */
+        virtual void setContext(const Dsp::Context context)
+        {
+            scratchArena.setContext(context, numberOfScratchBuffers);
         }
 
+        /**
+         * @brief Number of one-channel block buffers the scratch arena holds at the same time. Takes effect on the next setContext().
+         */
+        void setNumberOfScratchBuffers(int numberOfBuffers)
+        {
+            numberOfScratchBuffers = std::max(numberOfBuffers, 0);
+        }
+
+        /**
+         * @brief Temporary buffers for the current block; everything taken is given back when the next block starts.
+         */
+        Dsp::ScratchArena& getScratchArena() { return scratchArena; }
+
+        /**
+         * @brief Reserve scratch memory to order up to this many unsorted events per block without allocating.
+         *
+         * Larger unsorted lists are ordered in windows of this size, with one pass over the list per window.
+         * Only grows the reserved room, which starts at defaultNumberOfReservedEvents.
+         */
+        void reserveEvents(int maximumNumberOfMessages)
+        {
+            order.reserve(static_cast<size_t> (std::max(maximumNumberOfMessages, 0)));
+        }
+
+    #if ATH_DSP_INSTRUMENTATION
+        /**
+         * @brief Statistics of process(). Set its context to the host's sample rate and maximum block size.
+         */
+        LoadMonitor& getLoadMonitor() { return loadMonitor; }
+    #endif
+
         virtual void process(float * buffer, int numberOfSamples, Control::Midi::MessageMeta* messages, int numberOfMessages)
         {
-            // This loop will iterate over all the midi events AND the audio frames after the last midi event
+            process(AudioBlock<float>(buffer, numberOfSamples), messages, numberOfMessages);
+        }
+
+        virtual void process(AudioBlock<float> block, Control::Midi::MessageMeta* messages, int numberOfMessages)
+        {
+            const int numberOfSamples = block.getNumberOfSamples();
+
+            const Dsp::ScopedFlushDenormals flushDenormals;
+            const Dsp::ScopedNoAllocation noAllocation;
+            scratchArena.reset();
+
+        #if ATH_DSP_INSTRUMENTATION
+            loadMonitor.beginBlock();
+            eventsSinceRender = 0;
+        #endif
+
+            // Events are handed to dispatchEvent in order, followed by the audio frames after the last one
             // If there are no midi events, then it will just go through the audio frames in one go
 
+            bool sorted = true;
+            for (int i = 1; i < numberOfMessages && sorted; i++)
+                sorted = messages[i - 1].samplePosition <= messages[i].samplePosition;
+
             int currentSample = 0;
-            for (int i_midi = 0; i_midi < numberOfMessages + 1; i_midi++)
+
+            const auto makeKey = [&] (int i)
             {
-                bool processMidi = i_midi < numberOfMessages;
+                const int position = std::clamp(messages[i].samplePosition, 0, numberOfSamples);
+                return (static_cast<uint64_t> (position) << 32) | static_cast<uint32_t> (i);
+            };
 
-                int stopAtSample = numberOfSamples;
-                if (processMidi)
-                {
-                    Control::Midi::MessageMeta metadata = messages[i_midi];
-                    stopAtSample = metadata.samplePosition;
-                }
+            const auto dispatchKeys = [&]
+            {
+                for (const uint64_t key : order)
+                    dispatchEvent(block, currentSample, messages[static_cast<int> (key & 0xFFFFFFFFu)]);
+            };
 
-                //PROCESS AUDIO HERE
-                int samplesToProcess = stopAtSample - currentSample;
-                processBlock(&buffer[currentSample], samplesToProcess);
+            if (sorted)
+            {
+                for (int i = 0; i < numberOfMessages; i++) dispatchEvent(block, currentSample, messages[i]);
+            }
+            else if (static_cast<size_t> (numberOfMessages) <= order.capacity())
+            {
+                order.clear();
+                for (int i = 0; i < numberOfMessages; i++) order.push_back(makeKey(i));
+                std::sort(order.begin(), order.end());
 
-                currentSample = stopAtSample;
+                dispatchKeys();
+            }
+            else
+            {
+                // More events than reserved room: dispatch the next capacity() smallest keys at a time,
+                // selected into a max-heap in one pass over the list, so nothing allocates
+                const size_t window = order.capacity();
+                uint64_t lastKey = 0;
 
-                if (processMidi)
+                for (int dispatched = 0; dispatched < numberOfMessages; dispatched += static_cast<int> (order.size()))
                 {
-                    Control::Midi::MessageMeta metadata = messages[i_midi];
-                    auto message = metadata.message;
+                    order.clear();
+                    for (int i = 0; i < numberOfMessages; i++)
+                    {
+                        const uint64_t key = makeKey(i);
+                        if (dispatched > 0 && key <= lastKey) continue;
 
-                    //Fire midi event
-                    handleMidiEvent(message);
-                }
+                        if (order.size() < window)
+                        {
+                            order.push_back(key);
+                            std::push_heap(order.begin(), order.end());
+                        }
+                        else if (key < order.front())
+                        {
+                            std::pop_heap(order.begin(), order.end());
+                            order.back() = key;
+                            std::push_heap(order.begin(), order.end());
+                        }
+                    }
+
+                    std::sort_heap(order.begin(), order.end());
+                    lastKey = order.back();
 
+                    dispatchKeys();
+                }
             }
 
+            renderUpTo(block, currentSample, numberOfSamples);
+
+        #if ATH_DSP_INSTRUMENTATION
+            loadMonitor.endBlock(numberOfSamples);
+        #endif
         }
 
     };
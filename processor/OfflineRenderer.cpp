@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+
+#include "OfflineRenderer.h"
+
+namespace Ath::Processor
+{
+
+    void OfflineRenderer::setBlockSize (int numberOfSamplesPerBlock) { blockSize = std::max (numberOfSamplesPerBlock, 1); }
+
+    int OfflineRenderer::getBlockSize() const { return blockSize; }
+
+    std::vector<OfflineRenderResult> OfflineRenderer::render (std::span<const OfflineRenderJob> jobs, int numberOfThreads)
+    {
+        std::vector<OfflineRenderResult> results (jobs.size());
+        std::atomic<size_t> nextJob { 0 };
+
+        const auto work = [&]
+        {
+            for (size_t j = nextJob.fetch_add (1, std::memory_order_relaxed); j < jobs.size();
+                 j = nextJob.fetch_add (1, std::memory_order_relaxed))
+            {
+                results[j] = renderJob (jobs[j]);
+            }
+        };
+
+        const int threads = std::clamp (numberOfThreads, 1, std::max (static_cast<int> (jobs.size()), 1));
+
+        std::vector<std::thread> workers;
+        for (int t = 1; t < threads; t++) workers.emplace_back (work);
+
+        work();
+        for (auto& worker : workers) worker.join();
+
+        return results;
+    }
+
+    OfflineRenderResult OfflineRenderer::renderJob (const OfflineRenderJob& job) const
+    {
+        OfflineRenderResult result;
+        const auto start = std::chrono::steady_clock::now();
+
+        const int channels = std::clamp (job.numberOfChannels, 1, AudioBlock<float>::maximumNumberOfChannels);
+
+        AudioFileReader reader;
+        float sampleRate = job.sampleRate;
+        int64_t inputFrames = 0;
+
+        if (!job.inputPath.empty())
+        {
+            if (!reader.open (job.inputPath, job.inputFormat, channels, job.sampleRate))
+            {
+                result.error = "Cannot read " + job.inputPath;
+                return result;
+            }
+
+            sampleRate = reader.getSampleRate();
+            inputFrames = reader.getNumberOfFrames();
+        }
+
+        AudioFileWriter writer;
+        if (!writer.open (job.outputPath, job.outputFormat, channels, sampleRate))
+        {
+            result.error = "Cannot write " + job.outputPath;
+            return result;
+        }
+
+        std::unique_ptr<MidiAudioProcessor> processor = job.createProcessor ? job.createProcessor() : nullptr;
+        if (!processor)
+        {
+            result.error = "No processor";
+            return result;
+        }
+
+        result.sampleRate = sampleRate;
+        processor->setContext (Dsp::Context (sampleRate, blockSize));
+
+        // Stable, so events at the same position keep their order
+        std::vector<Control::Midi::MessageMeta> events (job.events);
+        std::stable_sort (events.begin(), events.end(), [] (const auto& a, const auto& b) { return a.samplePosition < b.samplePosition; });
+
+        processor->reserveEvents (static_cast<int> (events.size()));
+        std::vector<Control::Midi::MessageMeta> blockEvents;
+        blockEvents.reserve (events.size());
+
+        std::vector<float> storage (static_cast<size_t> (blockSize) * channels);
+        std::array<float*, AudioBlock<float>::maximumNumberOfChannels> pointers {};
+        for (int c = 0; c < channels; c++) pointers[c] = storage.data() + static_cast<size_t> (c) * blockSize;
+
+        const int64_t totalFrames = inputFrames + std::max<int64_t> (job.tailFrames, 0);
+        size_t eventIndex = 0;
+
+        for (int64_t position = 0; position < totalFrames; position += blockSize)
+        {
+            const int n = static_cast<int> (std::min<int64_t> (blockSize, totalFrames - position));
+            const AudioBlock<float> block (pointers.data(), channels, n);
+
+            // Input while it lasts, silence for the tail
+            const int read = reader.isOpen() ? reader.read (block) : 0;
+            block.getSubBlock (read, n - read).clear();
+
+            blockEvents.clear();
+            for (; eventIndex < events.size() && events[eventIndex].samplePosition < position + n; eventIndex++)
+            {
+                Control::Midi::MessageMeta event = events[eventIndex];
+                event.samplePosition = static_cast<int> (std::max<int64_t> (event.samplePosition - position, 0));
+                blockEvents.push_back (event);
+            }
+
+            processor->process (block, blockEvents.data(), static_cast<int> (blockEvents.size()));
+
+            if (!writer.write (block))
+            {
+                result.error = "Write failed: " + job.outputPath;
+                return result;
+            }
+
+            result.framesRendered += n;
+        }
+
+        if (!writer.close())
+        {
+            result.error = "Write failed: " + job.outputPath;
+            return result;
+        }
+
+        result.success = true;
+        result.seconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../control/Midi.h"
+#include "AudioFile.h"
+#include "MidiAudioProcessor.h"
+
+namespace Ath::Processor
+{
+
+    /**
+     * @brief One file to render: a patch, an optional input file, events and an output file.
+     */
+    struct OfflineRenderJob
+    {
+        /// Creates the patch; called on the thread that renders the job, so patches share nothing
+        std::function<std::unique_ptr<MidiAudioProcessor>()> createProcessor;
+
+        /// Input file streamed through the processor; empty to render from silence
+        std::string inputPath;
+        AudioFileFormat inputFormat = AudioFileFormat::Wav;
+
+        std::string outputPath;
+        AudioFileFormat outputFormat = AudioFileFormat::Wav;
+
+        /// Channels of the rendered block and the output file; input channels repeat cyclically to fill them
+        int numberOfChannels = 2;
+
+        /// Sample rate without an input file, and of raw input files; WAV input uses its own
+        float sampleRate = 48000.0f;
+
+        /// Frames after the end of the input (or in total, without one), e.g. for release tails
+        int64_t tailFrames = 0;
+
+        /// Events at absolute sample positions from the start of the file, in any order
+        std::vector<Control::Midi::MessageMeta> events;
+    };
+
+    struct OfflineRenderResult
+    {
+        bool success = false;
+        std::string error;
+
+        int64_t framesRendered = 0;
+        float sampleRate = 0.0f;
+        double seconds = 0.0;
+
+        /// Audio duration divided by rendering time
+        double getRealtimeFactor() const { return seconds > 0.0 ? framesRendered / (sampleRate * seconds) : 0.0; }
+    };
+
+    /**
+     * @brief Faster-than-realtime batch rendering of independent jobs across cores.
+     *
+     * Every job streams its input file through its own processor in large
+     * blocks (4096 frames by default) and writes the output as it goes, so
+     * memory stays constant for any file length. Events are sorted once and
+     * handed to process() block by block with block-relative positions, so a
+     * processor renders exactly as it would in a host with that block size.
+     *
+     * Jobs are distributed over a set of threads, each taking the next job as
+     * soon as it is done with one, which keeps every core busy for batches of
+     * uneven length. With no more jobs than threads, use fewer threads, since
+     * a single job is rendered by one thread.
+     *
+     *     OfflineRenderer renderer;
+     *     const auto results = renderer.render(jobs);
+     */
+    class OfflineRenderer
+    {
+    public:
+        /**
+         * @param numberOfSamplesPerBlock Block size passed to process(), and to setContext() as the maximum
+         */
+        void setBlockSize (int numberOfSamplesPerBlock);
+        int getBlockSize() const;
+
+        /**
+         * @brief Render all jobs, numberOfThreads at a time. Blocks until every job is done.
+         *
+         * @return One result per job, in job order
+         */
+        std::vector<OfflineRenderResult> render (std::span<const OfflineRenderJob> jobs,
+                                                 int numberOfThreads = static_cast<int> (std::thread::hardware_concurrency()));
+
+        /**
+         * @brief Render one job in the calling thread.
+         */
+        OfflineRenderResult renderJob (const OfflineRenderJob& job) const;
+
+    private:
+        int blockSize = 4096;
+    };
+}
@@ -0,0 +1,226 @@
+#include <array>
+
+#include "VoiceRenderPool.h"
+#include "../dsp/Denormals.h"
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #include <immintrin.h>
+#endif
+
+namespace Ath::Processor
+{
+
+    namespace
+    {
+        // Workers spin this many pauses between blocks (tens of microseconds) before sleeping
+        constexpr int spinsBeforeSleeping = 4096;
+
+        // The calling thread spins this many pauses for outstanding groups before yielding,
+        // so a preempted worker sharing its core can finish the group it holds
+        constexpr int spinsBeforeYielding = 256;
+
+        constexpr uint64_t packRange (uint32_t generation, int next, int end)
+        {
+            return static_cast<uint64_t> (generation) << 32 | static_cast<uint64_t> (next) << 16 | static_cast<uint64_t> (end);
+        }
+
+        inline void pause()
+        {
+        #if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+            _mm_pause();
+        #elif defined(__aarch64__) || defined(__arm__)
+            __asm__ __volatile__ ("yield");
+        #else
+            std::this_thread::yield();
+        #endif
+        }
+
+        // Best effort: without the privilege the thread keeps its normal priority and this returns false
+        bool setRealtimePriority()
+        {
+        #if defined(_WIN32)
+            return SetThreadPriority (GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != 0;
+        #elif defined(__unix__) || defined(__APPLE__)
+            sched_param parameters {};
+            parameters.sched_priority = std::max (sched_get_priority_max (SCHED_FIFO) - 10, sched_get_priority_min (SCHED_FIFO));
+            return pthread_setschedparam (pthread_self(), SCHED_FIFO, &parameters) == 0;
+        #else
+            return false;
+        #endif
+        }
+    }
+
+    VoiceRenderPool::VoiceRenderPool (int numberOfWorkers) : ranges (static_cast<size_t> (std::max (numberOfWorkers, 0) + 1))
+    {
+        for (int i = 0; i < std::max (numberOfWorkers, 0); i++)
+            workers.emplace_back ([this, i] { workerLoop (i); });
+
+        // Wait for every worker to have tried for real-time priority, so getNumberOfRealtimeWorkers() is final
+        for (int started = startedWorkers.load (std::memory_order_acquire); started < getNumberOfWorkers();
+             started = startedWorkers.load (std::memory_order_acquire))
+        {
+            startedWorkers.wait (started, std::memory_order_acquire);
+        }
+    }
+
+    VoiceRenderPool::~VoiceRenderPool()
+    {
+        stopping.store (true, std::memory_order_release);
+        generation.fetch_add (1, std::memory_order_release);
+        generation.notify_all();
+
+        for (auto& worker : workers) worker.join();
+    }
+
+    void VoiceRenderPool::prepare (int maximumGroups, int channels, int maximumSamples)
+    {
+        // Group indices are packed into 16 bits, see Range
+        maximumNumberOfGroups = std::clamp (maximumGroups, 0, 0xFFFF);
+        numberOfChannels = std::clamp (channels, 0, AudioBlock<float>::maximumNumberOfChannels);
+        maximumBlockSize = std::max (maximumSamples, 0);
+
+        // Every channel starts on a cache line, so groups never share one
+        constexpr int floatsPerLine = static_cast<int> (cacheLineSize / sizeof (float));
+        channelStride = (maximumBlockSize + floatsPerLine - 1) / floatsPerLine * floatsPerLine;
+
+        scratch.assign (static_cast<size_t> (channelStride) * numberOfChannels * maximumNumberOfGroups + floatsPerLine, 0.0f);
+
+        const auto address = reinterpret_cast<std::uintptr_t> (scratch.data());
+        scratchOffset = ((cacheLineSize - address % cacheLineSize) % cacheLineSize) / sizeof (float);
+    }
+
+    void VoiceRenderPool::setMinimumParallelBlockSize (int numberOfSamples) { minimumParallelBlockSize = std::max (numberOfSamples, 1); }
+
+    int VoiceRenderPool::getNumberOfWorkers() const { return static_cast<int> (workers.size()); }
+
+    int VoiceRenderPool::getNumberOfRealtimeWorkers() const { return realtimeWorkers.load (std::memory_order_acquire); }
+
+    float* VoiceRenderPool::getScratchChannel (int group, int channel)
+    {
+        return scratch.data() + scratchOffset + static_cast<size_t> (channelStride) * (static_cast<size_t> (group) * numberOfChannels + channel);
+    }
+
+    void VoiceRenderPool::runTask (const Task& task, int group)
+    {
+        std::array<float*, AudioBlock<float>::maximumNumberOfChannels> channels;
+        for (int c = 0; c < task.numberOfChannels; c++) channels[c] = getScratchChannel (group, c);
+
+        const AudioBlock<float> block (channels.data(), task.numberOfChannels, std::min (task.numberOfSamples, maximumBlockSize));
+        block.clear();
+
+        task.renderGroup (task.context, group, block);
+    }
+
+    void VoiceRenderPool::runParallel (const Task& task, int numberOfGroups)
+    {
+        const int participants = static_cast<int> (ranges.size());
+        const uint32_t taskGeneration = generation.load (std::memory_order_relaxed) + 1;
+
+        // No claim of an earlier generation can succeed any more, so no one reads the task while it is replaced
+        currentTask = task;
+        completedGroups.store (0, std::memory_order_relaxed);
+
+        // Contiguous ranges, so with even load every thread renders its own groups without stealing.
+        // The release stores publish the task to whoever claims from them.
+        for (int p = 0; p < participants; p++)
+            ranges[p].state.store (packRange (taskGeneration, numberOfGroups * p / participants, numberOfGroups * (p + 1) / participants),
+                                   std::memory_order_release);
+
+        generation.store (taskGeneration, std::memory_order_release);
+        generation.notify_all();
+
+        participate (participants - 1, taskGeneration);
+
+        // Wait for the groups still being rendered, not for workers that have not woken up yet
+        for (int spin = 0; completedGroups.load (std::memory_order_acquire) < numberOfGroups; spin++)
+        {
+            if (spin < spinsBeforeYielding) pause();
+            else std::this_thread::yield();
+        }
+    }
+
+    void VoiceRenderPool::participate (int participant, uint32_t taskGeneration)
+    {
+        const int participants = static_cast<int> (ranges.size());
+
+        for (int offset = 0; offset < participants; offset++)
+        {
+            Range& range = ranges[(participant + offset) % participants];
+            uint64_t state = range.state.load (std::memory_order_acquire);
+
+            while (true)
+            {
+                const int next = static_cast<int> ((state >> 16) & 0xFFFF);
+                const int end = static_cast<int> (state & 0xFFFF);
+
+                if (static_cast<uint32_t> (state >> 32) != taskGeneration || next >= end) break;
+
+                if (range.state.compare_exchange_weak (state, state + (uint64_t (1) << 16), std::memory_order_acquire))
+                {
+                    runTask (currentTask, next);
+                    completedGroups.fetch_add (1, std::memory_order_release);
+                }
+            }
+        }
+    }
+
+    void VoiceRenderPool::mix (const AudioBlock<float>& output, int numberOfGroups, int channels)
+    {
+        const int n = std::min (output.getNumberOfSamples(), maximumBlockSize);
+
+        for (int c = 0; c < channels; c++)
+        {
+            float* out = output.getChannel (c);
+
+            for (int group = 0; group < numberOfGroups; group++)
+            {
+                const float* in = getScratchChannel (group, c);
+                for (int i = 0; i < n; i++) out[i] += in[i];
+            }
+        }
+    }
+
+    void VoiceRenderPool::workerLoop (int index)
+    {
+        if (setRealtimePriority()) realtimeWorkers.fetch_add (1, std::memory_order_release);
+
+        startedWorkers.fetch_add (1, std::memory_order_release);
+        startedWorkers.notify_all();
+
+        // The floating-point mode is per thread; the audio thread sets its own in MidiAudioProcessor::process
+        const Dsp::ScopedFlushDenormals flushDenormals;
+
+        uint32_t seen = 0;
+
+        while (true)
+        {
+            uint32_t current = generation.load (std::memory_order_acquire);
+            for (int spin = 0; current == seen && spin < spinsBeforeSleeping; spin++)
+            {
+                pause();
+                current = generation.load (std::memory_order_acquire);
+            }
+
+            if (current == seen)
+            {
+                generation.wait (seen, std::memory_order_acquire);
+                continue;
+            }
+
+            seen = current;
+            if (stopping.load (std::memory_order_acquire)) return;
+
+            participate (index, current);
+        }
+    }
+}
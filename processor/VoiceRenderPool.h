@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "AudioBlock.h"
+
+namespace Ath::Processor
+{
+
+    /**
+     * @brief Renders groups of voices on a fixed pool of worker threads and mixes them in a fixed order.
+     *
+     * The workers are started in the constructor, with real-time priority
+     * where the platform allows it, and wait for render() calls from the audio
+     * thread, which takes part in the work as well. Each call is a set of
+     * tasks, one per voice group. Every participant draws tasks from its own
+     * range first and then steals from the others', with one atomic increment
+     * per task, so no locks are taken and idle threads pick up the slack of
+     * busy ones.
+     *
+     * Every group renders into its own scratch block, and the scratch blocks
+     * are added to the output in group order after all tasks are done, so the
+     * output is bit-identical whichever thread rendered which group, and to
+     * single-threaded rendering. Blocks shorter than the minimum parallel block
+     * size are rendered in the calling thread, where waking the workers would
+     * cost more than it saves.
+     *
+     * The calling thread waits only for the groups to be rendered, not for the
+     * workers: a worker that wakes after the groups of a call are taken finds
+     * nothing to do and goes back to waiting. Claims carry the call's
+     * generation, so a late worker can never take groups of a later call.
+     * Workers without real-time priority (see getNumberOfRealtimeWorkers())
+     * can still be preempted in the middle of a group, which the calling
+     * thread then has to wait for.
+     *
+     * Typical use, from MidiAudioProcessor::processBlock with one group per SIMD voice bank:
+     *
+     *     pool.render(block, numberOfBanks, [this](int bank, AudioBlock<float> scratch) { banks[bank].render(scratch); });
+     */
+    class VoiceRenderPool
+    {
+    public:
+        /**
+         * @param numberOfWorkers Threads started besides the calling one; 0 renders everything in the calling thread
+         */
+        explicit VoiceRenderPool (int numberOfWorkers = static_cast<int> (std::thread::hardware_concurrency()) - 1);
+
+        ~VoiceRenderPool();
+
+        VoiceRenderPool (const VoiceRenderPool&) = delete;
+        VoiceRenderPool& operator= (const VoiceRenderPool&) = delete;
+
+        /**
+         * @brief Allocate the scratch blocks. Call before processing starts.
+         */
+        void prepare (int maximumNumberOfGroups, int numberOfChannels, int maximumBlockSize);
+
+        /**
+         * @param numberOfSamples Blocks shorter than this are rendered single-threaded (default 64)
+         */
+        void setMinimumParallelBlockSize (int numberOfSamples);
+
+        int getNumberOfWorkers() const;
+
+        /**
+         * @brief Workers that got real-time priority. Fewer than getNumberOfWorkers() when the platform refused it, e.g. without the privilege.
+         */
+        int getNumberOfRealtimeWorkers() const;
+
+        /**
+         * @brief Render every group into a cleared scratch block, then add the scratch blocks to the output in group order.
+         *
+         * renderGroup is called concurrently for different groups, so groups
+         * must not share state that either of them writes.
+         *
+         * @param output Block to mix into; within the prepared channels and block size
+         * @param numberOfGroups At most the prepared maximum
+         * @param renderGroup Callable void(int group, AudioBlock<float> scratch)
+         */
+        template <typename F>
+        void render (const AudioBlock<float>& output, int numberOfGroups, F&& renderGroup)
+        {
+            const int numberOfSamples = output.getNumberOfSamples();
+            numberOfGroups = std::min (numberOfGroups, maximumNumberOfGroups);
+
+            if (numberOfSamples == 0 || numberOfGroups <= 0) return;
+
+            using Callable = std::remove_reference_t<F>;
+
+            Task task;
+            task.context = &renderGroup;
+            task.numberOfSamples = numberOfSamples;
+            task.numberOfChannels = std::min (output.getNumberOfChannels(), numberOfChannels);
+            task.renderGroup = [] (void* context, int group, AudioBlock<float> scratch)
+            {
+                (*static_cast<Callable*> (context)) (group, scratch);
+            };
+
+            if (workers.empty() || numberOfSamples < minimumParallelBlockSize || numberOfGroups == 1)
+            {
+                for (int group = 0; group < numberOfGroups; group++) runTask (task, group);
+            }
+            else
+            {
+                runParallel (task, numberOfGroups);
+            }
+
+            mix (output, numberOfGroups, task.numberOfChannels);
+        }
+
+    private:
+        static constexpr size_t cacheLineSize = 64;
+
+        struct Task
+        {
+            void (*renderGroup) (void*, int, AudioBlock<float>) = nullptr;
+            void* context = nullptr;
+            int numberOfSamples = 0;
+            int numberOfChannels = 0;
+        };
+
+        // Groups [next, end) of one participant, packed with the generation as generation << 32 | next << 16 | end.
+        // Others steal by advancing next too; a claim only succeeds for the generation it was woken for.
+        struct alignas (cacheLineSize) Range
+        {
+            std::atomic<uint64_t> state { 0 };
+        };
+
+        std::vector<std::thread> workers;
+        std::vector<Range> ranges;  // one per worker, then the calling thread's
+
+        Task currentTask;
+
+        alignas (cacheLineSize) std::atomic<uint32_t> generation { 0 };
+        alignas (cacheLineSize) std::atomic<int> completedGroups { 0 };
+        std::atomic<bool> stopping { false };
+
+        std::atomic<int> startedWorkers { 0 };
+        std::atomic<int> realtimeWorkers { 0 };
+
+        std::vector<float> scratch;
+        size_t scratchOffset = 0;   // first 64-byte aligned sample
+        int channelStride = 0;
+        int maximumNumberOfGroups = 0;
+        int numberOfChannels = 0;
+        int maximumBlockSize = 0;
+
+        int minimumParallelBlockSize = 64;
+
+        float* getScratchChannel (int group, int channel);
+
+        void runTask (const Task& task, int group);
+        void runParallel (const Task& task, int numberOfGroups);
+        void participate (int participant, uint32_t taskGeneration);
+        void mix (const AudioBlock<float>& output, int numberOfGroups, int channels);
+
+        void workerLoop (int index);
+    };
+}
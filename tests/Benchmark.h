@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Ath::Benchmark
+{
+    inline volatile double sink = 0.0;
+
+    /**
+     * @brief Keep a computed value alive, so the work producing it is not optimised away.
+     */
+    template <typename T>
+    static inline void doNotOptimize(T value)
+    {
+        sink = static_cast<double>(value);
+    }
+
+    struct Result
+    {
+        std::string name;
+        int blockSize = 0;
+
+        /// "sample", or "op" for cases timed per operation, whose fields below are then per operation
+        std::string unit = "sample";
+
+        double nsPerSample = 0.0;
+        double samplesPerSecond = 0.0;
+
+        /// Share of one core needed to run one instance in real time; 0 for cases timed per operation
+        double realtimePercent = 0.0;
+    };
+
+    /**
+     * @brief Minimal block-processing benchmark harness.
+     *
+     * Each case is a callable that processes one block. The harness calibrates
+     * how many calls fill a batch of at least batchTime, times a number of
+     * batches and keeps the fastest, which is the most stable figure on a
+     * machine with other load. Cases whose cost is per event rather than per
+     * sample are timed with runOperations() and reported per operation.
+     * Results are printed as they come and can be
+     * written as JSON, one result per line, so runs diff cleanly.
+     */
+    class Runner
+    {
+        std::vector<Result> results;
+        std::string filter;
+
+        double sampleRate = 48000.0;
+        double batchTime = 0.005;
+        int numberOfBatches = 9;
+
+        using Clock = std::chrono::steady_clock;
+
+        template <typename F>
+        static double time(F& f, long iterations)
+        {
+            const auto t0 = Clock::now();
+            for (long i = 0; i < iterations; i++) f();
+            const auto t1 = Clock::now();
+
+            return std::chrono::duration<double>(t1 - t0).count();
+        }
+
+        /**
+         * @return Seconds per call of the fastest batch
+         */
+        template <typename F>
+        double measure(F& f) const
+        {
+            // Warm up caches and branch predictors, then grow the batch until it is long enough to time
+            long iterations = 1;
+            time(f, iterations);
+            while (time(f, iterations) < batchTime) iterations *= 2;
+
+            double best = time(f, iterations);
+            for (int i = 1; i < numberOfBatches; i++) best = std::min(best, time(f, iterations));
+
+            return best / double(iterations);
+        }
+
+        void report(Result r)
+        {
+            char line[160];
+            if (r.unit == "sample")
+                std::snprintf(line, sizeof(line), "%-48s %6d %10.3f ns/sample %12.4g samples/s %9.4f %% realtime",
+                              r.name.c_str(), r.blockSize, r.nsPerSample, r.samplesPerSecond, r.realtimePercent);
+            else
+                std::snprintf(line, sizeof(line), "%-48s %6d %10.3f ns/%-6s %12.4g %s/s",
+                              r.name.c_str(), r.blockSize, r.nsPerSample, r.unit.c_str(), r.samplesPerSecond, r.unit.c_str());
+            std::cout << line << std::endl;
+
+            results.push_back(std::move(r));
+        }
+
+    public:
+        /**
+         * @param nameFilter Only cases whose name contains this are run; empty runs all
+         */
+        void setFilter(std::string nameFilter) { filter = std::move(nameFilter); }
+
+        /**
+         * @param rate Sample rate the realtime share is computed against
+         */
+        void setSampleRate(double rate) { sampleRate = rate; }
+
+        bool isEnabled(const std::string& name) const
+        {
+            return filter.empty() || name.find(filter) != std::string::npos;
+        }
+
+        /**
+         * @brief Time a case.
+         *
+         * @param name Case name, shared by all block sizes of the case
+         * @param blockSize Samples processed by one call of processBlock
+         * @param processBlock Callable processing one block of one instance
+         */
+        template <typename F>
+        void run(const std::string& name, int blockSize, F&& processBlock)
+        {
+            if (!isEnabled(name)) return;
+
+            const double seconds = measure(processBlock);
+
+            Result r;
+            r.name = name;
+            r.blockSize = blockSize;
+            r.nsPerSample = seconds * 1e9 / blockSize;
+            r.samplesPerSecond = 1e9 / r.nsPerSample;
+            r.realtimePercent = 100.0 * sampleRate / r.samplesPerSecond;
+            report(std::move(r));
+        }
+
+        /**
+         * @brief Time a case whose cost does not scale with a block size, such as event handling, per operation.
+         *
+         * @param name Case name
+         * @param operationsPerCall Operations (e.g. events) done by one call of f
+         * @param f Callable doing the operations
+         */
+        template <typename F>
+        void runOperations(const std::string& name, int operationsPerCall, F&& f)
+        {
+            if (!isEnabled(name)) return;
+
+            const double seconds = measure(f);
+
+            Result r;
+            r.name = name;
+            r.blockSize = operationsPerCall;
+            r.unit = "op";
+            r.nsPerSample = seconds * 1e9 / operationsPerCall;
+            r.samplesPerSecond = 1e9 / r.nsPerSample;
+            report(std::move(r));
+        }
+
+        const std::vector<Result>& getResults() const { return results; }
+
+        bool writeJson(const std::string& path) const
+        {
+            std::ofstream file(path);
+            if (!file) return false;
+
+            file << "{\n  \"sampleRate\": " << sampleRate << ",\n  \"results\": [\n";
+
+            for (size_t i = 0; i < results.size(); i++)
+            {
+                const auto& r = results[i];
+
+                char line[256];
+                std::snprintf(line, sizeof(line),
+                              "    {\"name\": \"%s\", \"blockSize\": %d, \"unit\": \"%s\", \"nsPerSample\": %.4f, \"samplesPerSecond\": %.6g, \"realtimePercent\": %.5f}",
+                              r.name.c_str(), r.blockSize, r.unit.c_str(), r.nsPerSample, r.samplesPerSecond, r.realtimePercent);
+
+                file << line << (i + 1 < results.size() ? ",\n" : "\n");
+            }
+
+            file << "  ]\n}\n";
+            return bool(file);
+        }
+    };
+}
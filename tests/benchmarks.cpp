@@ -0,0 +1,454 @@
+#include <array>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+
+#include "../control/Events.h"
+#include "../control/Midi.h"
+#include "../control/VoiceManager.h"
+#include "../dsp/Context.h"
+#include "../dsp/FIR.h"
+#include "../dsp/FIRSimd.h"
+#include "../dsp/Filter.h"
+#include "../dsp/cv/ExponentialSmoother.h"
+#include "../dsp/cv/LinearSmoother.h"
+#include "../dsp/cv/PercussionGeneratorBank.h"
+#include "../dsp/waveshaping/SoftClipper.h"
+#include "../math/Math.h"
+#include "../math/Simd.h"
+#include "../processor/MidiAudioProcessor.h"
+
+// Benchmarks of the per-block cost of the DSP kernels, see Benchmark.h.
+// Usage: ath_dsp_benchmarks [--json results.json] [--filter name]
+
+using namespace Ath;
+
+static constexpr float sampleRate = 48000.0f;
+static constexpr int blockSizes[] = { 32, 64, 128, 256, 512, 1024, 2048 };
+static constexpr int maximumBlockSize = 2048;
+
+static std::vector<float> makeNoise(int n)
+{
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    std::vector<float> noise(n);
+    for (auto& x : noise) x = dist(rng);
+    return noise;
+}
+
+static Dsp::Filter::Biquad::DigitalBiquadCoefficients<float> lowPassCoefficients(float cutoff, float q)
+{
+    // H(s) = 1 / (s^2 / w^2 + s / (w q) + 1)
+    const float w = 2.0f * 3.14159265f * cutoff;
+
+    Dsp::Filter::Biquad::AnalogBiquadCoefficients<float> analog;
+    analog.a1 = 1.0f / (w * q);
+    analog.a2 = 1.0f / (w * w);
+
+    return Dsp::Filter::Biquad::bilinear(analog, sampleRate);
+}
+
+template <Dsp::Filter::Biquad::BiquadTopology Topology>
+static void benchmarkBiquad(Benchmark::Runner& runner, const char* name, const std::vector<float>& input)
+{
+    std::vector<float> buffer(maximumBlockSize);
+
+    for (int n : blockSizes)
+    {
+        Dsp::Filter::Biquad::Biquad<float, Topology> biquad;
+        biquad.setCoefficients(lowPassCoefficients(1000.0f, 0.707f));
+
+        runner.run(name, n, [&]
+        {
+            biquad.processBlock(input.data(), buffer.data(), n);
+            Benchmark::doNotOptimize(buffer[n - 1]);
+        });
+    }
+}
+
+static void benchmarkFilters(Benchmark::Runner& runner, const std::vector<float>& input)
+{
+    using Dsp::Filter::Biquad::BiquadTopology;
+
+    benchmarkBiquad<BiquadTopology::DirectForm1>(runner, "Biquad DF1", input);
+    benchmarkBiquad<BiquadTopology::DirectForm2>(runner, "Biquad DF2", input);
+    benchmarkBiquad<BiquadTopology::TransposedDirectForm1>(runner, "Biquad TDF1", input);
+    benchmarkBiquad<BiquadTopology::TransposedDirectForm2>(runner, "Biquad TDF2", input);
+
+    std::vector<float> buffer(maximumBlockSize);
+
+    for (int n : blockSizes)
+    {
+        Dsp::Filter::Biquad::BiquadCascade<float, 4> cascade;
+        for (auto& b : cascade.biquads) b.setCoefficients(lowPassCoefficients(1000.0f, 0.707f));
+
+        runner.run("BiquadCascade<4> TDF2", n, [&]
+        {
+            cascade.processBlock(input.data(), buffer.data(), n);
+            Benchmark::doNotOptimize(buffer[n - 1]);
+        });
+    }
+
+    for (int taps : { 16, 64, 256 })
+    {
+        const std::string name = "Fir::Filter " + std::to_string(taps) + " taps";
+
+        for (int n : blockSizes)
+        {
+            Dsp::Filter::Fir::Filter<float> fir;
+            fir.setCoefficients(std::vector<float>(taps, 1.0f / float(taps)));
+
+            runner.run(name, n, [&]
+            {
+                for (int i = 0; i < n; i++) buffer[i] = fir.process(input[i]);
+                Benchmark::doNotOptimize(buffer[n - 1]);
+            });
+        }
+    }
+
+    for (int taps : { 16, 64, 256 })
+    {
+        const std::string name = "Fir::FilterSimd " + std::to_string(taps) + " taps";
+
+        for (int n : blockSizes)
+        {
+            Dsp::Filter::Fir::FilterSimd fir;
+            fir.setCoefficients(std::vector<float>(taps, 1.0f / float(taps)));
+
+            runner.run(name, n, [&]
+            {
+                fir.processBlock(input.data(), buffer.data(), n);
+                Benchmark::doNotOptimize(buffer[n - 1]);
+            });
+        }
+    }
+}
+
+static void benchmarkSines(Benchmark::Runner& runner)
+{
+    // Arguments in [0, 1), the range of a phase
+    std::vector<double> x(maximumBlockSize);
+    for (int i = 0; i < maximumBlockSize; i++) x[i] = double(i) / double(maximumBlockSize);
+
+    std::vector<double> buffer(maximumBlockSize);
+
+    const auto benchmarkSine = [&](const char* name, auto sine)
+    {
+        for (int n : blockSizes)
+        {
+            runner.run(name, n, [&]
+            {
+                for (int i = 0; i < n; i++) buffer[i] = sine(x[i]);
+                Benchmark::doNotOptimize(buffer[n - 1]);
+            });
+        }
+    };
+
+    benchmarkSine("std::sin", [](double v) { return std::sin(v); });
+    benchmarkSine("Math::sin", [](double v) { return Math::sin(v); });
+    benchmarkSine("Math::sin2pi5", [](double v) { return Math::sin2pi5(v); });
+    benchmarkSine("Math::sin2pi7", [](double v) { return Math::sin2pi7(v); });
+    benchmarkSine("Math::sin2pi9", [](double v) { return Math::sin2pi9(v); });
+}
+
+static void benchmarkSmoothers(Benchmark::Runner& runner)
+{
+    std::vector<float> buffer(maximumBlockSize);
+
+    // A new target every block keeps the smoothers moving
+    for (int n : blockSizes)
+    {
+        Dsp::Cv::ConstantTimeLinearSmoother<float> smoother;
+        smoother.setContext(Dsp::Context(sampleRate));
+        smoother.setTime(0.05f);
+
+        float target = 1.0f;
+        runner.run("ConstantTimeLinearSmoother", n, [&]
+        {
+            smoother.setTargetValue(target);
+            target = 1.0f - target;
+
+            smoother.processBlock(buffer.data(), n);
+            Benchmark::doNotOptimize(buffer[n - 1]);
+        });
+    }
+
+    for (int n : blockSizes)
+    {
+        Dsp::Cv::ExponentialSmoother<float> smoother;
+        smoother.setContext(Dsp::Context(sampleRate));
+        smoother.setTime(0.05f);
+
+        float target = 1.0f;
+        runner.run("ExponentialSmoother", n, [&]
+        {
+            smoother.setTargetValue(target);
+            target = 1.0f - target;
+
+            smoother.processBlock(buffer.data(), n);
+            Benchmark::doNotOptimize(buffer[n - 1]);
+        });
+    }
+}
+
+static void benchmarkWaveshapers(Benchmark::Runner& runner, const std::vector<float>& input)
+{
+    std::vector<float> buffer(maximumBlockSize);
+
+    for (int n : blockSizes)
+    {
+        Dsp::Waveshaper::SoftClipperSimd<3, Simd::float8> clipper;
+
+        runner.run("SoftClipperSimd<3> mono", n, [&]
+        {
+            clipper.processBlockMono(input.data(), buffer.data(), n);
+            Benchmark::doNotOptimize(buffer[n - 1]);
+        });
+    }
+
+    // One voice per lane: a sample here is a frame of 8 voices
+    std::vector<Simd::float8> frames(maximumBlockSize);
+    for (int i = 0; i < maximumBlockSize; i++) frames[i] = Simd::float8(input[i] * 2.0f);
+
+    for (int n : blockSizes)
+    {
+        Dsp::Waveshaper::SoftClipperSimd<3, Simd::float8> clipper;
+
+        runner.run("SoftClipperSimd<3> 8 voices", n, [&]
+        {
+            clipper.processBlock(frames.data(), n);
+
+            alignas(32) float last[8];
+            frames[n - 1].store(last);
+            Benchmark::doNotOptimize(last[7]);
+        });
+    }
+}
+
+static void benchmarkEventOutputs(Benchmark::Runner& runner)
+{
+    using Control::Midi::MessageNoteOn;
+
+    struct Voice
+    {
+        int notes = 0;
+        void noteOn(const MessageNoteOn& m) { notes += m.note; }
+    };
+
+    constexpr int numberOfVoices = 16;
+    constexpr int numberOfEvents = 1024;
+
+    // Note events spread round-robin over the voices
+    const auto benchmarkOutputs = [&](const char* name, auto& outputs, std::array<Voice, numberOfVoices>& voices)
+    {
+        runner.runOperations(name, numberOfEvents, [&]
+        {
+            for (int i = 0; i < numberOfEvents; i++)
+                outputs[i % numberOfVoices].fire({ .channel = 0, .note = static_cast<unsigned char>(i & 127), .velocity = 100 });
+
+            Benchmark::doNotOptimize(voices[0].notes);
+        });
+    };
+
+    std::array<Voice, numberOfVoices> v1, v2, v3;
+
+    std::array<Control::EventOutput<MessageNoteOn>, numberOfVoices> dynamicOutputs;
+    for (int i = 0; i < numberOfVoices; i++) dynamicOutputs[i].addMemberCallback(v1[i], &Voice::noteOn);
+
+    std::array<Control::FixedEventOutput<MessageNoteOn>, numberOfVoices> fixedOutputs;
+    for (int i = 0; i < numberOfVoices; i++)
+    {
+        if (!fixedOutputs[i].addMemberCallback<&Voice::noteOn>(v2[i])) return;
+    }
+
+    using StaticOutput = decltype(Control::connectStatic<MessageNoteOn>(Control::bindMember<&Voice::noteOn>(v3[0])));
+    std::vector<StaticOutput> staticOutputs;
+    for (int i = 0; i < numberOfVoices; i++)
+        staticOutputs.push_back(Control::connectStatic<MessageNoteOn>(Control::bindMember<&Voice::noteOn>(v3[i])));
+
+    benchmarkOutputs("EventOutput fire, 16 voices", dynamicOutputs, v1);
+    benchmarkOutputs("FixedEventOutput fire, 16 voices", fixedOutputs, v2);
+    benchmarkOutputs("StaticEventOutput fire, 16 voices", staticOutputs, v3);
+}
+
+static void benchmarkVoiceManager(Benchmark::Runner& runner)
+{
+    using Control::Midi::MessageNoteOn;
+    using Control::Midi::MessageNoteOff;
+
+    struct Voice
+    {
+        int notes = 0;
+        void noteOn(const MessageNoteOn& m) { notes += m.note; }
+        void noteOff(const MessageNoteOff& m) { notes -= m.note; }
+    };
+
+    constexpr int numberOfVoices = 16;
+
+    Control::VoiceManager manager(numberOfVoices);
+    manager.setStealingPolicy(Control::VoiceManager::StealingPolicy::Oldest);
+
+    std::array<Voice, numberOfVoices> voices;
+    for (int i = 0; i < numberOfVoices; i++)
+    {
+        manager.noteOn_out(i).addMemberCallback(voices[i], &Voice::noteOn);
+        manager.noteOff_out(i).addMemberCallback(voices[i], &Voice::noteOff);
+    }
+
+    // A chord of 24 notes, so 8 of them steal, then all released: 48 events, whatever the block size
+    runner.runOperations("VoiceManager note event, 24-note chords", 48, [&]
+    {
+        for (unsigned char note = 40; note < 64; note++)
+            manager.handleNoteOn({ .channel = 0, .note = note, .velocity = 100 });
+        for (unsigned char note = 40; note < 64; note++)
+            manager.handleNoteOff({ .channel = 0, .note = note, .velocity = 0 });
+
+        Benchmark::doNotOptimize(voices[0].notes);
+    });
+}
+
+static void benchmarkVoiceRendering(Benchmark::Runner& runner)
+{
+    constexpr int numberOfVoices = 64;
+    constexpr int lanes = Simd::float8::VectorSize;
+
+    std::vector<Simd::float8> frames(maximumBlockSize);
+
+    // Sparse playing: 4 held notes out of 64 voices, all packed into the first group
+    for (bool skipSilent : { false, true })
+    {
+        const std::string name = skipSilent ? "PercussionGeneratorBank 4 of 64 voices, sounding groups"
+                                            : "PercussionGeneratorBank 4 of 64 voices, all groups";
+
+        for (int n : blockSizes)
+        {
+            Control::VoiceManager manager(numberOfVoices);
+            Dsp::Cv::PercussionGeneratorBank<Simd::float8, numberOfVoices> bank;
+            bank.setContext(Dsp::Context(sampleRate, maximumBlockSize));
+            if (!bank.connect(manager))
+            {
+                std::cerr << "PercussionGeneratorBank could not connect to the VoiceManager" << std::endl;
+                return;
+            }
+
+            for (unsigned char note = 60; note < 64; note++)
+                manager.handleNoteOn({ .channel = 0, .note = note, .velocity = 100 });
+
+            runner.run(name, n, [&]
+            {
+                const auto render = [&](int group)
+                {
+                    bank.processBlock(group, frames.data(), n);
+                    bank.reportVoiceLevels(group, manager);
+                };
+
+                if (skipSilent) for (const int group : manager.getGroupsToRender(lanes)) render(group);
+                else for (int group = 0; group < numberOfVoices / lanes; group++) render(group);
+
+                alignas(32) float last[8];
+                frames[n - 1].store(last);
+                Benchmark::doNotOptimize(last[0]);
+            });
+        }
+    }
+}
+
+namespace
+{
+    /**
+     * A stereo polarity switch, flipped by the note-on velocity, so the level stays put over repeated runs.
+     */
+    class GainProcessor : public Processor::MidiAudioProcessor
+    {
+        float gain = 1.0f;
+
+    public:
+        using MidiAudioProcessor::processBlock;
+
+        void processBlock(float* buffer, int numberOfSamples) override
+        {
+            for (int i = 0; i < numberOfSamples; i++) buffer[i] *= gain;
+        }
+
+        void handleMidiEvent(Control::Midi::Message message) override
+        {
+            if (message.isNoteOn()) gain = message.data2 >= 64 ? 1.0f : -1.0f;
+        }
+    };
+}
+
+static void benchmarkMidiAudioProcessor(Benchmark::Runner& runner, const std::vector<float>& input)
+{
+    constexpr int numberOfMessages = 8;
+
+    std::vector<float> left(input), right(input);
+    float* channels[] = { left.data(), right.data() };
+
+    for (int granule : { 1, 32 })
+    {
+        const std::string name = "MidiAudioProcessor stereo 8 events" + std::string(granule == 1 ? "" : " granule 32");
+
+        for (int n : blockSizes)
+        {
+            GainProcessor processor;
+            processor.setMinimumSubBlockSize(granule);
+            processor.reserveEvents(numberOfMessages);
+
+            std::array<Control::Midi::MessageMeta, numberOfMessages> messages;
+            for (int i = 0; i < numberOfMessages; i++)
+            {
+                messages[i].message = { .status = 0x90, .data1 = 60, .data2 = static_cast<unsigned char>(i & 1 ? 100 : 20) };
+                messages[i].samplePosition = i * n / numberOfMessages + 1;
+            }
+
+            runner.run(name, n, [&]
+            {
+                processor.process(Processor::AudioBlock<float>(channels, 2, n), messages.data(), numberOfMessages);
+                Benchmark::doNotOptimize(left[n - 1]);
+            });
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Benchmark::Runner runner;
+    runner.setSampleRate(sampleRate);
+
+    std::string jsonPath;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) jsonPath = argv[++i];
+        else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) runner.setFilter(argv[++i]);
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--json results.json] [--filter name]" << std::endl;
+            return 1;
+        }
+    }
+
+    const auto input = makeNoise(maximumBlockSize);
+
+    benchmarkFilters(runner, input);
+    benchmarkSines(runner);
+    benchmarkSmoothers(runner);
+    benchmarkWaveshapers(runner, input);
+    benchmarkEventOutputs(runner);
+    benchmarkVoiceManager(runner);
+    benchmarkVoiceRendering(runner);
+    benchmarkMidiAudioProcessor(runner, input);
+
+    if (!jsonPath.empty() && !runner.writeJson(jsonPath))
+    {
+        std::cerr << "Could not write " << jsonPath << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,8 +1,8 @@
 
-#include <array>
-#include <iostream>
-#include <chrono>
+#include <algorithm>
+#include <cmath>
 #include <ranges>
+#include <string>
 #include <vector>
 
 #include <matplot/matplot.h>
@@ -10,11 +10,10 @@
 #include "matplot/core/legend.h"
 #include "matplot/freestanding/axes_functions.h"
 
+#include "../dsp/waveshaping/SoftClipper.h"
 #include "../math/Math.h"
 #include "../math/Special.h"
 
-static volatile double sink = 0.0; // prevents optimization
-
 auto plot = [](auto& x, auto& y, const char* name)
 {
     auto p = matplot::plot(x, y);
@@ -95,46 +94,6 @@ int main(int argc, char *argv[])
         matplot::save("plot1sinpoly.png");
     }
 
-    // Benchmark sines
-    {
-        auto run = [&](auto fn)
-        {
-            constexpr size_t iterations = 1e8;
-            constexpr size_t size = 1e3;
-
-            std::array<double, 1000> x;
-            for (size_t i = 0; i < size; i++)
-            x[i] = (double(i) / double(size));
-
-            auto t0 = std::chrono::high_resolution_clock::now();
-
-            double acc = 0.0;
-            for (size_t i = 0; i < iterations; ++i)
-                acc += fn(x[i%1000]);
-
-            auto t1 = std::chrono::high_resolution_clock::now();
-            sink = acc;
-
-            std::chrono::duration<double, std::milli> ms = t1 - t0;
-            return ms.count();
-        };
-
-        std::cout << "Benchmark 1e8 calls to sine" << std::endl;
-        auto t_std = run([](double v){ return std::sin(v); });
-        auto t_sin = run([](double v){ return Ath::Math::sin(v); });
-        auto t_sin2pi5 = run([](double v){ return Ath::Math::sin2pi5(v); });
-        auto t_sin2pi7 = run([](double v){ return Ath::Math::sin2pi7(v); });
-        auto t_sin2pi9 = run([](double v){ return Ath::Math::sin2pi9(v); });
-        
-        std::vector t = {t_std, t_sin, t_sin2pi5, t_sin2pi7, t_sin2pi9};
-        matplot::figure();
-        matplot::bar(t);
-        matplot::gca()->x_axis().ticklabels({"std", "sin", "sin2pi5", "sin2pi7", "sin2pi9"});
-
-        matplot::title("Execution time of 1e8 calls to sine, ms");    
-        matplot::save("plot2sinbench.png");
-    }
-
     // math/Special.h
     {
         auto x1 = matplot::linspace(-1, 1, 1000);
@@ -164,5 +123,53 @@ int main(int argc, char *argv[])
         matplot::save("plot3lanczos.png");
     }
 
+    // Low-frequency ADAA: consecutive samples of a mono stream are close, so the
+    // antiderivative difference must not cancel into noise above the clipper's bound
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int numberOfSamples = 96000;
+
+        const float k = std::sqrt(1.0f / 3.0f);
+        const auto clip = [k](float x)
+        {
+            if (std::abs(x) >= 1.0f) return std::copysign(1.0f, x);
+            const float u = x * k;
+            return (u - u * u * u) / (k - k * k * k);
+        };
+
+        matplot::figure();
+        matplot::hold(matplot::on);
+
+        double maximumError = 0.0;
+        for (const double frequency : { 1.0, 5.0, 50.0 })
+        {
+            std::vector<float> in(numberOfSamples), out(numberOfSamples);
+            for (int i = 0; i < numberOfSamples; i++) in[i] = 0.9f * static_cast<float>(std::sin(Ath::Math::tau<double> * frequency * i / sampleRate));
+
+            Ath::Dsp::Waveshaper::SoftClipperSimd<3, Simd::float8> clipper;
+            clipper.reset();
+            clipper.processBlockMono(in.data(), out.data(), numberOfSamples);
+
+            std::vector<double> t, error;
+            for (int i = 1; i < numberOfSamples; i++)
+            {
+                const double e = out[i] - clip(0.5f * (in[i] + in[i - 1]));
+                maximumError = std::max(maximumError, std::abs(e));
+                t.push_back(i / sampleRate);
+                error.push_back(e * 1e3);
+            }
+
+            plot(t, error, (std::to_string(static_cast<int>(frequency)) + " Hz, error * 1e3").c_str());
+        }
+
+        auto lg = matplot::legend();
+        lg->location(matplot::legend::general_alignment::bottomright);
+
+        matplot::title("SoftClipperSimd<3>::processBlockMono against f(midpoint)");
+        matplot::save("plot4adaalowfrequency.png");
+
+        if (maximumError > 5e-3) return 1;
+    }
+
     return 0;
 }
\ No newline at end of file